@@ -6,14 +6,180 @@
 #include <cstdlib>
 #include <iomanip>
 #include <map>
+#include <set>
+#include <array>
+#include <unordered_map>
 #include <algorithm>
+#include <cmath>
+#include <random>
 #include <thread>
 #include <mutex>
 #include <atomic>
 #include <queue>
 #include <condition_variable>
 #include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <limits>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <fstream>
+#include <cctype>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
 #include "z3++.h"
+#include "z3_version.h"
+
+// Per-variable initial values (phase hints) arrived in Z3 4.13.3
+#if Z3_MAJOR_VERSION > 4 || (Z3_MAJOR_VERSION == 4 && (Z3_MINOR_VERSION > 13 || \
+    (Z3_MINOR_VERSION == 13 && Z3_BUILD_NUMBER >= 3)))
+#define HAVE_Z3_INITIAL_VALUE 1
+#else
+#define HAVE_Z3_INITIAL_VALUE 0
+#endif
+
+// ============================================================
+//  CellSpan - Read-only view of a partition's cells
+// ============================================================
+//  Partitions live in a shared immutable table (see PartitionTable);
+//  encoders and verifiers read them through this non-owning view.
+//  Implicitly constructible from std::vector<int> for ad-hoc callers.
+// ============================================================
+
+class CellSpan {
+    const int* first = nullptr;
+    const int* last = nullptr;
+
+public:
+    CellSpan() = default;
+    CellSpan(const int* b, const int* e) : first(b), last(e) {}
+    CellSpan(const std::vector<int>& v) : first(v.data()), last(v.data() + v.size()) {}
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+    int operator[](size_t i) const { return first[i]; }
+};
+
+// ============================================================
+//  SetTables - Compile-time subset lookup tables
+// ============================================================
+//  Built once, at compile time, for the largest supported powerset
+//  (n = 7: 128 subsets, so subset bitsets are 128 bits wide).
+//  Disjoint pairs are grouped by their union, so the pairs of a
+//  universe with powerset size ps are a prefix of the table and the
+//  group of U lists the submasks of U. Encoders and verifiers walk
+//  these lists instead of filtering ps^2 or ps^4 candidates.
+// ============================================================
+
+namespace SetTables {
+    using Bits = unsigned __int128;
+    constexpr int MAX_UNIVERSE = 7;
+    constexpr int MAX_PS = 1 << MAX_UNIVERSE;
+    constexpr int MAX_DISJOINT = 2187;  // 3^MAX_UNIVERSE
+
+    // Index of the lowest set bit of m (m != 0)
+    inline int lowest(Bits m) {
+        uint64_t low = static_cast<uint64_t>(m);
+        return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll(static_cast<uint64_t>(m >> 64));
+    }
+
+    struct Pair {
+        uint8_t a, b;
+    };
+
+    // Number of elements of each subset mask
+    constexpr std::array<uint8_t, MAX_PS> POPCOUNT = [] {
+        std::array<uint8_t, MAX_PS> counts{};
+        for (int S = 1; S < MAX_PS; ++S) counts[S] = counts[S >> 1] + (S & 1);
+        return counts;
+    }();
+
+    // Bit j of SUPERSETS[i] is set iff i ⊆ j
+    constexpr std::array<Bits, MAX_PS> SUPERSETS = [] {
+        std::array<Bits, MAX_PS> masks{};
+        for (int i = 0; i < MAX_PS; ++i) {
+            for (int j = 0; j < MAX_PS; ++j) {
+                if ((i & ~j) == 0) masks[i] |= Bits(1) << j;
+            }
+        }
+        return masks;
+    }();
+
+    // Bit j of SUBSETS[i] is set iff j ⊆ i
+    constexpr std::array<Bits, MAX_PS> SUBSETS = [] {
+        std::array<Bits, MAX_PS> masks{};
+        for (int i = 0; i < MAX_PS; ++i) {
+            for (int j = 0; j < MAX_PS; ++j) {
+                if ((j & ~i) == 0) masks[i] |= Bits(1) << j;
+            }
+        }
+        return masks;
+    }();
+
+    // UNION_BEGIN[U]: first pair of DISJOINT with a ∪ b = U
+    constexpr std::array<int, MAX_PS + 1> UNION_BEGIN = [] {
+        std::array<int, MAX_PS + 1> begin{};
+        for (int U = 0; U < MAX_PS; ++U) begin[U + 1] = begin[U] + (1 << POPCOUNT[U]);
+        return begin;
+    }();
+
+    // Every (a, b) with a ∩ b = ∅, grouped by a ∪ b ascending; within
+    // a group, a runs over the submasks of the union in descending order
+    constexpr std::array<Pair, MAX_DISJOINT> DISJOINT = [] {
+        std::array<Pair, MAX_DISJOINT> pairs{};
+        int k = 0;
+        for (int U = 0; U < MAX_PS; ++U) {
+            for (int A = U; ; A = (A - 1) & U) {
+                pairs[k++] = {static_cast<uint8_t>(A), static_cast<uint8_t>(U & ~A)};
+                if (A == 0) break;
+            }
+        }
+        return pairs;
+    }();
+    static_assert(UNION_BEGIN[MAX_PS] == MAX_DISJOINT, "disjoint pair count");
+
+    struct PairRange {
+        const Pair* first;
+        const Pair* last;
+        const Pair* begin() const { return first; }
+        const Pair* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+    };
+
+    // All disjoint (a, b) of a universe with powerset size ps (3^n pairs)
+    inline PairRange disjoint_pairs(int ps) {
+        return {DISJOINT.data(), DISJOINT.data() + UNION_BEGIN[ps]};
+    }
+
+    // The submasks a of S, each with its complement b = S∖a
+    inline PairRange submasks(int S) {
+        return {DISJOINT.data() + UNION_BEGIN[S], DISJOINT.data() + UNION_BEGIN[S + 1]};
+    }
+
+    // Bit j set iff i ⊆ j, restricted to a powerset of size ps
+    constexpr Bits supersets(int i, int ps) {
+        return ps == MAX_PS ? SUPERSETS[i] : SUPERSETS[i] & ((Bits(1) << ps) - 1);
+    }
+}
 
 // ============================================================
 //  Bitmask Utilities
@@ -51,12 +217,8 @@ namespace BitOps {
     
     // Count elements in set (popcount)
     inline int cardinality(int mask) {
-        int count = 0;
-        while (mask) {
-            count += mask & 1;
-            mask >>= 1;
-        }
-        return count;
+        assert(mask >= 0 && mask < SetTables::MAX_PS);
+        return SetTables::POPCOUNT[mask];
     }
     
     // Convert bitmask to string representation like "{0,2,3}"
@@ -80,7 +242,7 @@ namespace BitOps {
     // 2. Does not contain empty set
     // 3. Covers the universe Omega
     // 4. Elements are pairwise disjoint
-    bool verify_partition(const std::vector<int>& partition, int universe_size) {
+    bool verify_partition(CellSpan partition, int universe_size) {
         int full_set = (1 << universe_size) - 1;
 
         // Check 1: Partition is not empty
@@ -134,7 +296,7 @@ namespace BitOps {
     // The field is the closure of the partition cells under union and complementation.
     // For a partition with k cells, the field has 2^k elements
     // Each element is a union of some subset of the partition cells
-    std::vector<int> generate_field(const std::vector<int>& partition, int universe_size) {
+    std::vector<int> generate_field(CellSpan partition, int universe_size) {
         int k = static_cast<int>(partition.size());
         int field_size = 1 << k;  // 2^k elements in the field
         std::vector<int> field;
@@ -156,7 +318,7 @@ namespace BitOps {
     }
 
     // Convert partition to string representation
-    std::string partition_to_string(const std::vector<int>& partition, int n) {
+    std::string partition_to_string(CellSpan partition, int n) {
         std::ostringstream oss;
         oss << "[";
         for (size_t i = 0; i < partition.size(); ++i) {
@@ -426,32 +588,565 @@ namespace PartitionEnumerator {
     }
 }
 
+// ============================================================
+//  PartitionTable - Shared immutable table of all partitions
+// ============================================================
+//  Built once per universe size. Cells of every partition are
+//  flattened into one contiguous array; a partition is addressed
+//  by its id (index in enumeration order) and read as a CellSpan.
+//  Ordered pairs (I1, I2), I1 != I2, are numbered row-major so
+//  that task id k maps to partition ids without a pair list.
+// ============================================================
+
+class PartitionTable {
+    int n;
+    std::vector<int> cells;           // All cells, partition after partition
+    std::vector<uint32_t> offsets;    // offsets[p]..offsets[p+1] = cells of partition p
+
+public:
+    explicit PartitionTable(int universe_size) : n(universe_size) {
+        auto partitions = PartitionEnumerator::generate_all_partitions(universe_size);
+        offsets.reserve(partitions.size() + 1);
+        offsets.push_back(0);
+        for (const auto& p : partitions) {
+            cells.insert(cells.end(), p.begin(), p.end());
+            offsets.push_back(static_cast<uint32_t>(cells.size()));
+        }
+    }
+
+    int universe_size() const { return n; }
+    int count() const { return static_cast<int>(offsets.size()) - 1; }
+    int pair_count() const { return count() * (count() - 1); }
+
+    CellSpan cells_of(int partition_id) const {
+        return CellSpan(cells.data() + offsets[partition_id],
+                        cells.data() + offsets[partition_id + 1]);
+    }
+
+    // Decode pair index k into (i, j), i != j, matching generate_partition_pairs order
+    std::pair<int, int> pair_at(int k) const {
+        int row = count() - 1;
+        int i = k / row;
+        int j = k % row;
+        if (j >= i) ++j;
+        return {i, j};
+    }
+
+    // Inverse of pair_at
+    int pair_index(int i, int j) const {
+        return i * (count() - 1) + (j > i ? j - 1 : j);
+    }
+};
+
+// ============================================================
+//  PairSymmetry - Automorphisms of a partition pair
+// ============================================================
+//  Permutations of Omega that map each partition of a pair onto
+//  itself. Such a permutation carries frames of the pair to frames
+//  of the same pair, so enumeration may keep one frame per orbit.
+//  Each automorphism is returned as its action on subset masks.
+// ============================================================
+
+namespace PairSymmetry {
+    inline bool preserves(const std::vector<int>& image, CellSpan cells) {
+        for (int c : cells) {
+            if (std::find(cells.begin(), cells.end(), image[c]) == cells.end()) return false;
+        }
+        return true;
+    }
+
+    // Subset maps of all automorphisms, identity first
+    std::vector<std::vector<int>> subset_maps(CellSpan I1, CellSpan I2, int n) {
+        std::vector<std::vector<int>> maps;
+        std::vector<int> perm(n);
+        for (int i = 0; i < n; ++i) perm[i] = i;
+        do {
+            std::vector<int> image(1 << n, 0);
+            for (int mask = 0; mask < (1 << n); ++mask) {
+                for (int i = 0; i < n; ++i) {
+                    if (BitOps::contains(mask, i)) image[mask] |= 1 << perm[i];
+                }
+            }
+            if (preserves(image, I1) && preserves(image, I2)) maps.push_back(std::move(image));
+        } while (std::next_permutation(perm.begin(), perm.end()));
+        return maps;
+    }
+}
+
+// ============================================================
+//  PairOrbits - Partition pairs up to relabelling of Omega
+// ============================================================
+//  A permutation of Omega carries frames of (I1, I2) to frames of
+//  the permuted pair, so one pair per orbit decides the orbit.
+//  Representatives are streamed without listing the pairs: I1
+//  runs over the lowest id of each partition class, I2 over the
+//  partitions the stabilizer of I1 cannot map to a lower id.
+// ============================================================
+
+class PairOrbits {
+    const PartitionTable& table;
+    int num_perms = 0;
+    std::vector<uint16_t> images;   // images[perm * count + p]: id of p relabelled by perm
+
+public:
+    explicit PairOrbits(const PartitionTable& pt) : table(pt) {
+        int n = pt.universe_size();
+        int ps = 1 << n;
+        // A partition is identified by each element's smallest cell-mate,
+        // three bits per element
+        auto key_of = [n](const int* cells, size_t count) {
+            uint32_t key = 0;
+            for (size_t c = 0; c < count; ++c) {
+                uint32_t low = static_cast<uint32_t>(__builtin_ctz(cells[c]));
+                for (int e = 0; e < n; ++e) {
+                    if (BitOps::contains(cells[c], e)) key |= low << (3 * e);
+                }
+            }
+            return key;
+        };
+        std::unordered_map<uint32_t, uint16_t> id_of;
+        for (int p = 0; p < pt.count(); ++p) {
+            CellSpan cells = pt.cells_of(p);
+            id_of[key_of(cells.begin(), cells.size())] = static_cast<uint16_t>(p);
+        }
+
+        std::vector<int> perm(n), mask_image(ps), mapped;
+        for (int i = 0; i < n; ++i) perm[i] = i;
+        do {
+            for (int mask = 0; mask < ps; ++mask) {
+                mask_image[mask] = 0;
+                for (int i = 0; i < n; ++i) {
+                    if (BitOps::contains(mask, i)) mask_image[mask] |= 1 << perm[i];
+                }
+            }
+            for (int p = 0; p < pt.count(); ++p) {
+                mapped.clear();
+                for (int c : pt.cells_of(p)) mapped.push_back(mask_image[c]);
+                images.push_back(id_of.at(key_of(mapped.data(), mapped.size())));
+            }
+            ++num_perms;
+        } while (std::next_permutation(perm.begin(), perm.end()));
+    }
+
+    // visit(task_id, orbit_size) for every representative, by increasing
+    // I1 then I2; the orbit sizes add up to table.pair_count()
+    template <class Visit>
+    void for_each_representative(Visit visit) const {
+        int count = table.count();
+        std::vector<int> stabilizer;
+        for (int i = 0; i < count; ++i) {
+            stabilizer.clear();
+            bool lowest = true;
+            for (int g = 0; g < num_perms && lowest; ++g) {
+                int q = images[static_cast<size_t>(g) * count + i];
+                lowest = q >= i;
+                if (q == i) stabilizer.push_back(g);
+            }
+            if (!lowest) continue;
+            for (int j = 0; j < count; ++j) {
+                if (j == i) continue;
+                bool rep = true;
+                int fixing = 0;   // Automorphisms of the pair
+                for (int g : stabilizer) {
+                    int q = images[static_cast<size_t>(g) * count + j];
+                    if (q < j) {
+                        rep = false;
+                        break;
+                    }
+                    fixing += q == j;
+                }
+                if (rep) visit(table.pair_index(i, j), num_perms / fixing);
+            }
+        }
+    }
+};
+
+// ============================================================
+//  NativeFrame - Bit-packed relations and native axiom checks
+// ============================================================
+//  A relation on the powerset as one 64-bit row per subset: bit j
+//  of rows[i] is R[i][j] (n <= 6). The checks follow AxiomEncoder
+//  axiom by axiom, so frames can be validated or screened without
+//  a Z3 context.
+// ============================================================
+
+namespace NativeFrame {
+    using Row = uint64_t;
+    constexpr int MAX_UNIVERSE = 6;
+
+    inline bool get(const Row* rows, int i, int j) {
+        return (rows[i] >> j) & 1;
+    }
+
+    std::vector<Row> from_matrix(const std::vector<std::vector<bool>>& matrix) {
+        std::vector<Row> rows(matrix.size(), 0);
+        for (size_t i = 0; i < matrix.size(); ++i) {
+            for (size_t j = 0; j < matrix[i].size(); ++j) {
+                if (matrix[i][j]) rows[i] |= Row(1) << j;
+            }
+        }
+        return rows;
+    }
+
+    std::vector<std::vector<bool>> to_matrix(const Row* rows, int ps) {
+        std::vector<std::vector<bool>> matrix(ps, std::vector<bool>(ps));
+        for (int i = 0; i < ps; ++i) {
+            for (int j = 0; j < ps; ++j) matrix[i][j] = get(rows, i, j);
+        }
+        return matrix;
+    }
+
+    // Transitivity, monotonicity, non-triviality, CSTP and strict CSTP
+    bool common_axioms(const Row* rows, int ps) {
+        for (int i = 0; i < ps; ++i) {
+            for (Row m = rows[i]; m; m &= m - 1) {
+                int j = __builtin_ctzll(m);
+                if (rows[j] & ~rows[i]) return false;          // R[i][j], R[j][k], not R[i][k]
+            }
+            Row up = static_cast<Row>(SetTables::supersets(i, ps));
+            if ((rows[i] & up) != up) return false;
+        }
+        if (get(rows, ps - 1, 0)) return false;
+
+        SetTables::PairRange pairs = SetTables::disjoint_pairs(ps);
+        for (const auto& ab : pairs) {
+            int A = ab.a, B = ab.b, AB = A | B;
+            for (const auto& cd : pairs) {
+                int C = cd.a, D = cd.b, CD = C | D;
+                bool AC = get(rows, A, C), BD = get(rows, B, D);
+                if (!AC || !BD) continue;
+                bool ABCD = get(rows, AB, CD), CDAB = get(rows, CD, AB);
+                if (!ABCD) return false;
+                if (!get(rows, C, A) && !get(rows, D, B) && CDAB) return false;
+            }
+        }
+        return true;
+    }
+
+    // comparable(E, F) -> some cell C with comparable(E∩C, F∩C)
+    bool not_dilation(const Row* rows, int ps, CellSpan partition) {
+        for (int E = 0; E < ps; ++E) {
+            for (int F = E; F < ps; ++F) {
+                if (!get(rows, E, F) && !get(rows, F, E)) continue;
+                bool found = false;
+                for (int C : partition) {
+                    int EC = E & C, FC = F & C;
+                    if (get(rows, EC, FC) || get(rows, FC, EC)) {
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found) return false;
+            }
+        }
+        return true;
+    }
+
+    // CK[S] for every S: the largest set in the common field of the
+    // two partitions' fields that is contained in S. The field is
+    // closed under union, so CK[S] is S itself or the union of CK
+    // over S minus one element.
+    std::vector<int> common_knowledge(CellSpan I1, CellSpan I2, int n) {
+        Row in1 = 0, in2 = 0;
+        for (int G : BitOps::generate_field(I1, n)) in1 |= Row(1) << G;
+        for (int G : BitOps::generate_field(I2, n)) in2 |= Row(1) << G;
+        Row common = in1 & in2;
+        std::vector<int> ck(1 << n, 0);
+        for (int S = 1; S < (1 << n); ++S) {
+            if ((common >> S) & 1) {
+                ck[S] = S;
+                continue;
+            }
+            for (int m = S; m; m &= m - 1) ck[S] |= ck[S & ~(m & -m)];
+        }
+        return ck;
+    }
+
+    // A2D: some (E, F) with CK[E∩I1 ≤ F∩I1] ∩ CK[E∩I2 ≰ F∩I2] ≠ ∅
+    bool agreeing_to_disagree(const Row* rows, int ps, CellSpan I1, CellSpan I2,
+                              const std::vector<int>& ck) {
+        for (int E = 0; E < ps; ++E) {
+            for (int F = 0; F < ps; ++F) {
+                int A = 0, B = 0;
+                for (int C : I1) {
+                    if (get(rows, E & C, F & C)) A |= C;
+                }
+                for (int C : I2) {
+                    if (!get(rows, E & C, F & C)) B |= C;
+                }
+                if (ck[A] & ck[B]) return true;
+            }
+        }
+        return false;
+    }
+}
+
+// ============================================================
+//  WideFrame - 128-bit row relations up to n = 7
+// ============================================================
+//  The NativeFrame layout with one 128-bit row per subset, for
+//  universes past the native engine. Z3 models at n = 7 are
+//  checked in this form against the axioms encoded lazily (see
+//  AxiomEncoder::encode_violated_common_axioms).
+// ============================================================
+
+namespace WideFrame {
+    using Row = SetTables::Bits;
+
+    inline bool get(const Row* rows, int i, int j) {
+        return static_cast<bool>((rows[i] >> j) & 1);
+    }
+
+    std::vector<Row> from_matrix(const std::vector<std::vector<bool>>& matrix) {
+        std::vector<Row> rows(matrix.size(), 0);
+        for (size_t i = 0; i < matrix.size(); ++i) {
+            for (size_t j = 0; j < matrix[i].size(); ++j) {
+                if (matrix[i][j]) rows[i] |= Row(1) << j;
+            }
+        }
+        return rows;
+    }
+
+    // cols[j] bit i = R[i][j]
+    std::vector<Row> transpose(const Row* rows, int ps) {
+        std::vector<Row> cols(ps, 0);
+        for (int i = 0; i < ps; ++i) {
+            for (Row m = rows[i]; m; m &= m - 1) cols[SetTables::lowest(m)] |= Row(1) << i;
+        }
+        return cols;
+    }
+}
+
+// ============================================================
+//  FrameSearch<N> - Native frame kernels for a fixed universe size
+// ============================================================
+//  The NativeFrame checks with n as a template parameter: the
+//  powerset size, subset / superset masks and disjoint-pair lists
+//  are compile-time tables and partition cells sit in fixed-size
+//  arrays with a compile-time bound. CSTP is checked a whole row
+//  of D at a time and Not-Dilation a whole row of F. FrameKernels
+//  picks the instantiation for n once, as a table of function
+//  pointers.
+// ============================================================
+
+template <int N>
+struct FrameSearch {
+    static_assert(N >= 2 && N <= NativeFrame::MAX_UNIVERSE, "universe size out of range");
+    using Row = NativeFrame::Row;
+    static constexpr int PS = 1 << N;
+    static constexpr int FULL = PS - 1;
+
+    // Bit j of SUPERSETS[i] is set iff i ⊆ j (monotonicity)
+    static constexpr std::array<Row, PS> SUPERSETS = [] {
+        std::array<Row, PS> masks{};
+        for (int i = 0; i < PS; ++i) {
+            masks[i] = static_cast<Row>(SetTables::supersets(i, PS));
+        }
+        return masks;
+    }();
+
+    // Every (A, B) with A ∩ B = ∅: a prefix of the shared table
+    static constexpr int DISJOINT_PAIRS = SetTables::UNION_BEGIN[PS];
+    static constexpr const SetTables::Pair* DISJOINT = SetTables::DISJOINT.data();
+
+    // A partition has at most N cells
+    struct Cells {
+        std::array<int, N> cell{};
+        int count = 0;
+    };
+
+    static Cells cells_of(CellSpan partition) {
+        Cells c;
+        for (int C : partition) c.cell[c.count++] = C;
+        return c;
+    }
+
+    static bool get(const Row* rows, int i, int j) { return (rows[i] >> j) & 1; }
+
+    // Bit D of SUBSETS[X] is set iff D ⊆ X
+    static constexpr std::array<Row, PS> SUBSETS = [] {
+        std::array<Row, PS> masks{};
+        for (int X = 0; X < PS; ++X) masks[X] = static_cast<Row>(SetTables::SUBSETS[X]);
+        return masks;
+    }();
+
+    using Frame = std::array<Row, PS>;
+
+    // cols[j] bit i = R[i][j]
+    static Frame transpose(const Row* rows) {
+        Frame cols{};
+        for (int i = 0; i < PS; ++i) {
+            for (Row m = rows[i]; m; m &= m - 1) cols[__builtin_ctzll(m)] |= Row(1) << i;
+        }
+        return cols;
+    }
+
+    // CSTP and strict CSTP are checked for all D ⊆ Ω∖C at once: with
+    // C ∩ D = ∅, bit D of row[X] >> C is R[X][C ∪ D]
+    static bool common_axioms(const Row* rows) {
+        for (int i = 0; i < PS; ++i) {
+            if ((rows[i] & SUPERSETS[i]) != SUPERSETS[i]) return false;
+            for (Row m = rows[i]; m; m &= m - 1) {
+                if (rows[__builtin_ctzll(m)] & ~rows[i]) return false;
+            }
+        }
+        if (get(rows, FULL, 0)) return false;
+
+        Frame cols = transpose(rows);
+        for (int k = 0; k < DISJOINT_PAIRS; ++k) {
+            int A = DISJOINT[k].a, B = DISJOINT[k].b, AB = A | B;
+            Row BD = rows[B], DB = cols[B];
+            for (int C = 0; C < PS; ++C) {
+                bool AC = get(rows, A, C), CA = get(rows, C, A);
+                if (!AC) continue;
+                Row ABCD = rows[AB] >> C, CDAB = cols[AB] >> C;
+                Row bad = BD & ~ABCD;
+                if (!CA) bad |= BD & ~DB & ~(ABCD & ~CDAB);
+                if (bad & SUBSETS[FULL & ~C]) return false;
+            }
+        }
+        return true;
+    }
+
+    // Bit F of PROJECT[C][s] is set iff F ∩ C = s
+    static constexpr std::array<std::array<Row, PS>, PS> PROJECT = [] {
+        std::array<std::array<Row, PS>, PS> masks{};
+        for (int C = 0; C < PS; ++C) {
+            for (int F = 0; F < PS; ++F) masks[C][F & C] |= Row(1) << F;
+        }
+        return masks;
+    }();
+
+    // comp[X] bit Y: X and Y are R-comparable
+    static Frame comparability(const Row* rows) {
+        Frame comp = transpose(rows);
+        for (int X = 0; X < PS; ++X) comp[X] |= rows[X];
+        return comp;
+    }
+
+    // For each E, the F with some cell C making (E∩C, F∩C) comparable
+    // are a union of PROJECT masks; every F comparable to E must be
+    // among them
+    static bool not_dilation(const Frame& comp, const Cells& partition) {
+        for (int E = 0; E < PS; ++E) {
+            Row covered = 0;
+            for (int k = 0; k < N && k < partition.count; ++k) {
+                int C = partition.cell[k];
+                for (Row m = comp[E & C] & SUBSETS[C]; m; m &= m - 1) {
+                    covered |= PROJECT[C][__builtin_ctzll(m)];
+                }
+            }
+            if (comp[E] & ~covered) return false;
+        }
+        return true;
+    }
+
+    // CellSpan / PartitionTable entry points for FrameKernels
+    static bool not_dilation_span(const Row* rows, CellSpan partition) {
+        return not_dilation(comparability(rows), cells_of(partition));
+    }
+
+    static void not_dilation_table(const Row* rows, const PartitionTable& table, uint8_t* out) {
+        Frame comp = comparability(rows);
+        for (int p = 0; p < table.count(); ++p) out[p] = not_dilation(comp, cells_of(table.cells_of(p)));
+    }
+
+    // A2D usually succeeds within the first few (E, F), so the
+    // generic early-exit loop, with PS fixed, is kept
+    static bool agreeing_to_disagree_span(const Row* rows, CellSpan I1, CellSpan I2,
+                                          const std::vector<int>& ck) {
+        return NativeFrame::agreeing_to_disagree(rows, PS, I1, I2, ck);
+    }
+};
+
+struct FrameKernels {
+    using Row = NativeFrame::Row;
+    bool (*common_axioms)(const Row* rows);
+    bool (*not_dilation)(const Row* rows, CellSpan partition);
+    // out[p]: Not-Dilation for every partition p of the table
+    void (*not_dilation_table)(const Row* rows, const PartitionTable& table, uint8_t* out);
+    bool (*agreeing_to_disagree)(const Row* rows, CellSpan I1, CellSpan I2,
+                                 const std::vector<int>& ck);
+
+    template <int N>
+    static FrameKernels of() {
+        return {&FrameSearch<N>::common_axioms, &FrameSearch<N>::not_dilation_span,
+                &FrameSearch<N>::not_dilation_table, &FrameSearch<N>::agreeing_to_disagree_span};
+    }
+
+    // Kernels for universe size n (2..6); the 64-bit rows stop at 6
+    static FrameKernels for_universe(int n) {
+        switch (n) {
+            case 2: return of<2>();
+            case 3: return of<3>();
+            case 4: return of<4>();
+            case 5: return of<5>();
+            case 6: return of<6>();
+            default:
+                std::cerr << "No native frame kernels for universe size " << n << "\n";
+                std::abort();
+        }
+    }
+};
+
 // ============================================================
 //  FrameVariables - Holds Z3 symbolic variables
 // ============================================================
-//  Decoupled from solver; can be shared across multiple solvers
+//  Decoupled from solver; can be shared across multiple solvers.
+//  R is either a matrix of Boolean constants or, experimentally,
+//  one bit-vector of width ps per row with R[i][j] = bit j of
+//  row i; encoders address entries by index either way.
 // ============================================================
 
+enum class RelationEncoding {
+    MATRIX,     // ps^2 Boolean constants
+    ROWS        // ps bit-vectors of width ps
+};
+
 class FrameVariables {
     z3::context& ctx;
     int n;              // Universe size
     int powerset_size;  // 2^n subsets
-    std::vector<std::vector<z3::expr>> R;  // R[i][j] = (subset_i ≤ subset_j)
+    std::vector<z3::expr> R;               // R[i*ps+j] = (subset_i ≤ subset_j)
+    std::vector<z3::expr> not_R;           // ¬R[i*ps+j], kept alive for raw clause building
+    std::vector<z3::expr> rows;            // ROWS only: row i as a bit-vector
+    std::vector<int8_t> fixed_value;       // Per entry i*ps+j: -1 free, else folded constant
 
 public:
-    FrameVariables(z3::context& c, int universe_size, bool silent = false)
+    FrameVariables(z3::context& c, int universe_size, bool silent = false,
+                   RelationEncoding encoding = RelationEncoding::MATRIX)
         : ctx(c), n(universe_size), powerset_size(1 << universe_size) {
         
-        // Create boolean matrix R[i][j]
-        for (int i = 0; i < powerset_size; ++i) {
-            R.emplace_back();
-            for (int j = 0; j < powerset_size; ++j) {
-                std::string var_name = "R_" + std::to_string(i) + "_" + std::to_string(j);
-                R[i].push_back(ctx.bool_const(var_name.c_str()));
+        // Create boolean matrix R, one flat row-major array; entry e is
+        // named by the integer symbol e (printed as k!e), or is bit j of
+        // the row constant named by the integer symbol i
+        int entries = powerset_size * powerset_size;
+        R.reserve(entries);
+        not_R.reserve(entries);
+        if (encoding == RelationEncoding::ROWS) {
+            z3::expr one = ctx.bv_val(1, 1);
+            for (int i = 0; i < powerset_size; ++i) {
+                rows.emplace_back(ctx, Z3_mk_const(ctx, Z3_mk_int_symbol(ctx, i), Z3_mk_bv_sort(ctx, powerset_size)));
+                for (int j = 0; j < powerset_size; ++j) {
+                    z3::expr r(ctx, Z3_mk_eq(ctx, Z3_mk_extract(ctx, j, j, rows.back()), one));
+                    not_R.emplace_back(ctx, Z3_mk_not(ctx, r));
+                    R.push_back(r);
+                }
+            }
+        } else {
+            for (int e = 0; e < entries; ++e) {
+                Z3_ast r = Z3_mk_const(ctx, Z3_mk_int_symbol(ctx, e), Z3_mk_bool_sort(ctx));
+                R.emplace_back(ctx, r);
+                not_R.emplace_back(ctx, Z3_mk_not(ctx, r));
             }
         }
+        ctx.check_error();
         if (!silent) {
-            std::cout << "Created " << (powerset_size * powerset_size) << " boolean variables\n";
+            if (rows.empty()) {
+                std::cout << "Created " << entries << " boolean variables\n";
+            } else {
+                std::cout << "Created " << powerset_size << " row bit-vectors of width " << powerset_size << "\n";
+            }
         }
     }
 
@@ -459,8 +1154,43 @@ public:
     z3::context& context() { return ctx; }
     int universe_size() const { return n; }
     int size() const { return powerset_size; }
-    z3::expr& get_R(int i, int j) { return R[i][j]; }
-    const z3::expr& get_R(int i, int j) const { return R[i][j]; }
+    z3::expr& get_R(int i, int j) { return R[index(i, j)]; }
+    const z3::expr& get_R(int i, int j) const { return R[index(i, j)]; }
+
+    // Entry id of R[i][j]: the native engines' literal numbering
+    int index(int i, int j) const { return i * powerset_size + j; }
+
+    // ROWS only: row i, and a constant row with the given bits
+    bool has_rows() const { return !rows.empty(); }
+    const z3::expr& row(int i) const { return rows[i]; }
+    z3::expr row_mask(SetTables::Bits bits) const {
+        if (powerset_size <= 64) return ctx.bv_val(static_cast<uint64_t>(bits), powerset_size);
+        return z3::concat(ctx.bv_val(static_cast<uint64_t>(bits >> 64), powerset_size - 64),
+                          ctx.bv_val(static_cast<uint64_t>(bits), 64));
+    }
+
+    // R[i][j] or ¬R[i][j] as a borrowed AST (valid while this object
+    // lives), for encoders that build clauses through the C API
+    Z3_ast lit(int i, int j, bool positive = true) const {
+        return positive ? R[index(i, j)] : not_R[index(i, j)];
+    }
+
+    // Replace every entry the backbone fixes (0/1; -1 = free) by that
+    // constant, so encoders can fold it away (see Backbone)
+    void fix(const std::vector<int8_t>& backbone) {
+        fixed_value = backbone;
+        for (int e = 0; e < powerset_size * powerset_size; ++e) {
+            if (backbone[e] >= 0) {
+                R[e] = ctx.bool_val(backbone[e] == 1);
+                not_R[e] = ctx.bool_val(backbone[e] == 0);
+            }
+        }
+    }
+
+    // Folded value of R[i][j]: 1 or 0, or -1 while it is a variable
+    int fixed(int i, int j) const {
+        return fixed_value.empty() ? -1 : fixed_value[index(i, j)];
+    }
 };
 
 // ============================================================
@@ -470,21 +1200,62 @@ public:
 //  Supports silent mode for parallel workers
 // ============================================================
 
+enum class A2DEncoding {
+    EXPANDED,   // One disjunct per (E, F) and cell pattern
+    WITNESS     // E and F as symbolic witnesses (see encode_A2D_witness)
+};
+
+enum class Totality {
+    OFF,        // R is a preorder
+    CLAUSES,    // Total preorder: R[i][j] ∨ R[j][i] added as clauses
+    RANKS       // Total preorder: R[i][j] ⟺ rank(i) ≤ rank(j) (see encode_totality)
+};
+
 class AxiomEncoder {
     FrameVariables& vars;
     bool silent;
+    A2DEncoding a2d_encoding = A2DEncoding::EXPANDED;
+    Totality totality = Totality::OFF;
+    std::vector<Z3_ast> clause;   // Scratch literals for add_clause
+
+    // Assert the disjunction of the literals in `clause`. The literals
+    // are borrowed from FrameVariables, so building the clause costs
+    // one Z3_mk_or and no reference-count updates per literal.
+    void add_clause(z3::solver& s) {
+        z3::context& ctx = vars.context();
+        Z3_solver_assert(ctx, s, Z3_mk_or(ctx, static_cast<unsigned>(clause.size()), clause.data()));
+        ctx.check_error();
+    }
+
+    void add_clause(z3::solver& s, std::initializer_list<Z3_ast> lits) {
+        clause.assign(lits);
+        add_clause(s);
+    }
 
 public:
     AxiomEncoder(FrameVariables& v, bool silent_mode = false) : vars(v), silent(silent_mode) {}
 
     // AXIOM: Transitivity - if i ≤ j and j ≤ k, then i ≤ k
     void encode_transitivity(z3::solver& s) {
+        if (totality == Totality::RANKS) return;   // Implied by the ranks
         if (!silent) std::cout << "  Encoding transitivity...\n";
+        if (vars.has_rows()) {
+            // R[i][j] → row_j ⊆ row_i; with reflexivity this is transitivity
+            for (int i = 0; i < vars.size(); ++i) {
+                for (int j = 0; j < vars.size(); ++j) {
+                    if (i == j || vars.fixed(i, j) == 0) continue;
+                    s.add(z3::implies(vars.get_R(i, j), (vars.row(i) | vars.row(j)) == vars.row(i)));
+                }
+            }
+            return;
+        }
         for (int i = 0; i < vars.size(); ++i) {
             for (int j = 0; j < vars.size(); ++j) {
+                if (vars.fixed(i, j) == 0) continue;
                 for (int k = 0; k < vars.size(); ++k) {
+                    if (vars.fixed(j, k) == 0 || vars.fixed(i, k) == 1) continue;
                     // (R[i][j] ∧ R[j][k]) → R[i][k]
-                    s.add(z3::implies(vars.get_R(i, j) && vars.get_R(j, k), vars.get_R(i, k)));
+                    add_clause(s, {vars.lit(i, j, false), vars.lit(j, k, false), vars.lit(i, k)});
                 }
             }
         }
@@ -493,11 +1264,18 @@ public:
     // AXIOM: Monotonicity - subset inclusion implies ordering
     void encode_monotonicity(z3::solver& s) {
         if (!silent) std::cout << "  Encoding monotonicity...\n";
+        if (vars.has_rows()) {
+            // Row i contains the supersets of i: one fixed mask per row
+            for (int i = 0; i < vars.size(); ++i) {
+                z3::expr mask = vars.row_mask(SetTables::supersets(i, vars.size()));
+                s.add((vars.row(i) & mask) == mask);
+            }
+            return;
+        }
         for (int i = 0; i < vars.size(); ++i) {
-            for (int j = 0; j < vars.size(); ++j) {
-                if (BitOps::is_subset(i, j)) {
-                    s.add(vars.get_R(i, j));  // i ⊆ j → i ≤ j
-                }
+            for (SetTables::Bits m = SetTables::supersets(i, vars.size()); m; m &= m - 1) {
+                int j = SetTables::lowest(m);
+                if (vars.fixed(i, j) != 1) s.add(vars.get_R(i, j));  // i ⊆ j → i ≤ j
             }
         }
     }
@@ -507,24 +1285,21 @@ public:
         if (!silent) std::cout << "  Encoding non-triviality...\n";
         int full_set = vars.size() - 1;  // Assuming full set is the last subset
         int empty_set = 0;                // Assuming empty set is the first subset
-        s.add(!vars.get_R(full_set, empty_set));
+        if (vars.fixed(full_set, empty_set) != 0) s.add(!vars.get_R(full_set, empty_set));
     }
 
     // Axiom: Comparative Sure-thing Principle (CSTP) - for any disjoint subsets A, B and disjoint subsets C, D, if A ≤ C and B ≤ D, then A ∪ B ≤ C ∪ D.
     void encode_CSTP(z3::solver& s) {
         if (!silent) std::cout << "  Encoding Comparative Sure-thing Principle (CSTP)...\n";
-        for (int A = 0; A < vars.size(); ++A) {
-            for (int B = 0; B < vars.size(); ++B) {
-                if (BitOps::set_intersection(A, B) != 0) continue; // A and B must be disjoint
-                for (int C = 0; C < vars.size(); ++C) {
-                    for (int D = 0; D < vars.size(); ++D) {
-                        if (BitOps::set_intersection(C, D) != 0) continue; // C and D must be disjoint
-                        int AB = BitOps::set_union(A, B);
-                        int CD = BitOps::set_union(C, D);
-                        // (R[A][C] ∧ R[B][D]) → R[AB][CD]
-                        s.add(z3::implies(vars.get_R(A, C) && vars.get_R(B, D), vars.get_R(AB, CD)));
-                    }
-                }
+        SetTables::PairRange pairs = SetTables::disjoint_pairs(vars.size());
+        for (const auto& ab : pairs) {              // A and B disjoint
+            int A = ab.a, B = ab.b, AB = A | B;
+            for (const auto& cd : pairs) {          // C and D disjoint
+                int C = cd.a, D = cd.b, CD = C | D;
+                if (vars.fixed(A, C) == 0 || vars.fixed(B, D) == 0 ||
+                    vars.fixed(AB, CD) == 1) continue;
+                // (R[A][C] ∧ R[B][D]) → R[AB][CD]
+                add_clause(s, {vars.lit(A, C, false), vars.lit(B, D, false), vars.lit(AB, CD)});
             }
         }
     }
@@ -532,28 +1307,124 @@ public:
     // Axiom: Strict CSTP - for any subsets A, B, C, D, if A ∩ B = ∅ and C ∩ D = ∅, then (A < C and B < D) implies (A ∪ B) < (C ∪ D) where A < B means that A ≤ B and NOT B ≤ A.
     void encode_strict_CSTP(z3::solver& s) {
         if (!silent) std::cout << "  Encoding Strict Comparative Sure-thing Principle (Strict CSTP)...\n";
-        for (int A = 0; A < vars.size(); ++A) {
-            for (int B = 0; B < vars.size(); ++B) {
-                if (BitOps::set_intersection(A, B) != 0) continue; // A and B must be disjoint
-                for (int C = 0; C < vars.size(); ++C) {
-                    for (int D = 0; D < vars.size(); ++D) {
-                        if (BitOps::set_intersection(C, D) != 0) continue; // C and D must be disjoint
-                        int AB = BitOps::set_union(A, B);
-                        int CD = BitOps::set_union(C, D);
-                        // ((R[A][C] ∧ ¬R[C][A]) ∧ (R[B][D] ∧ ¬R[D][B])) → (R[AB][CD] ∧ ¬R[CD][AB])
-                        z3::expr A_less_C = vars.get_R(A, C) && !vars.get_R(C, A);
-                        z3::expr B_less_D = vars.get_R(B, D) && !vars.get_R(D, B);
-                        z3::expr AB_less_CD = vars.get_R(AB, CD) && !vars.get_R(CD, AB);
-                        s.add(z3::implies(A_less_C && B_less_D, AB_less_CD));
-                    }
+        SetTables::PairRange pairs = SetTables::disjoint_pairs(vars.size());
+        if (totality != Totality::OFF) {
+            // Total: X < Y is ¬R[Y][X], so (¬R[C][A] ∧ ¬R[D][B]) → ¬R[CD][AB]
+            for (const auto& ab : pairs) {
+                int A = ab.a, B = ab.b, AB = A | B;
+                for (const auto& cd : pairs) {
+                    int C = cd.a, D = cd.b, CD = C | D;
+                    if (vars.fixed(C, A) == 1 || vars.fixed(D, B) == 1 || vars.fixed(CD, AB) == 0) continue;
+                    add_clause(s, {vars.lit(C, A), vars.lit(D, B), vars.lit(CD, AB, false)});
+                }
+            }
+            return;
+        }
+        for (const auto& ab : pairs) {              // A and B disjoint
+            int A = ab.a, B = ab.b, AB = A | B;
+            for (const auto& cd : pairs) {          // C and D disjoint
+                int C = cd.a, D = cd.b, CD = C | D;
+                if (vars.fixed(A, C) == 0 || vars.fixed(C, A) == 1 ||
+                    vars.fixed(B, D) == 0 || vars.fixed(D, B) == 1 ||
+                    (vars.fixed(AB, CD) == 1 && vars.fixed(CD, AB) == 0)) continue;
+                // ((R[A][C] ∧ ¬R[C][A]) ∧ (R[B][D] ∧ ¬R[D][B])) → (R[AB][CD] ∧ ¬R[CD][AB]),
+                // one clause per conjunct of the conclusion
+                Z3_ast premise[4] = {vars.lit(A, C, false), vars.lit(C, A), vars.lit(B, D, false), vars.lit(D, B)};
+                if (vars.fixed(AB, CD) != 1) {
+                    add_clause(s, {premise[0], premise[1], premise[2], premise[3], vars.lit(AB, CD)});
+                }
+                if (vars.fixed(CD, AB) != 0) {
+                    add_clause(s, {premise[0], premise[1], premise[2], premise[3], vars.lit(CD, AB, false)});
                 }
             }
         }
     }
 
-    // Encode all common (partition-independent) axioms at once
-    void encode_common_axioms(z3::solver& s) {
-        encode_transitivity(s);
+    // Lazy common axioms: add the transitivity, CSTP and strict CSTP
+    // clauses that the candidate frame `rows` violates, at most `limit`
+    // of them. CSTP is scanned a row of D at a time: with C ∩ D = ∅,
+    // bit D of rows[X] >> C is R[X][C ∪ D]. Returns the number of
+    // clauses added; 0 means the frame satisfies all three axioms.
+    int encode_violated_common_axioms(z3::solver& s, const WideFrame::Row* rows, int limit) {
+        using WideFrame::Row;
+        int ps = vars.size();
+        int added = 0;
+        for (int i = 0; i < ps && added < limit; ++i) {
+            for (Row m = rows[i]; m && added < limit; m &= m - 1) {
+                int j = SetTables::lowest(m);
+                for (Row bad = rows[j] & ~rows[i]; bad && added < limit; bad &= bad - 1) {
+                    int k = SetTables::lowest(bad);
+                    add_clause(s, {vars.lit(i, j, false), vars.lit(j, k, false), vars.lit(i, k)});
+                    ++added;
+                }
+            }
+        }
+
+        std::vector<Row> cols = WideFrame::transpose(rows, ps);
+        int full = ps - 1;
+        for (const auto& ab : SetTables::disjoint_pairs(ps)) {
+            int A = ab.a, B = ab.b, AB = A | B;
+            for (int C = 0; C < ps && added < limit; ++C) {
+                if (!WideFrame::get(rows, A, C)) continue;
+                bool CA = WideFrame::get(rows, C, A);
+                Row ABCD = rows[AB] >> C, CDAB = cols[AB] >> C;
+                Row D_range = SetTables::SUBSETS[full & ~C];
+                // R[A][C], R[B][D] but not R[AB][CD]: CSTP
+                for (Row bad = rows[B] & ~ABCD & D_range; bad && added < limit; bad &= bad - 1) {
+                    int CD = C | SetTables::lowest(bad), D = CD & ~C;
+                    add_clause(s, {vars.lit(A, C, false), vars.lit(B, D, false), vars.lit(AB, CD)});
+                    ++added;
+                }
+                if (CA) continue;
+                // A < C, B < D, R[AB][CD] but also R[CD][AB]: strict CSTP
+                for (Row bad = rows[B] & ~cols[B] & ABCD & CDAB & D_range; bad && added < limit;
+                     bad &= bad - 1) {
+                    int CD = C | SetTables::lowest(bad), D = CD & ~C;
+                    add_clause(s, {vars.lit(A, C, false), vars.lit(C, A), vars.lit(B, D, false),
+                                   vars.lit(D, B), vars.lit(CD, AB, false)});
+                    ++added;
+                }
+            }
+            if (added >= limit) break;
+        }
+        return added;
+    }
+
+    // AXIOM: Totality (optional) - every pair is comparable: R[i][j] ∨ R[j][i].
+    // With ranks, each subset gets an n-bit rank (ps levels suffice for
+    // any total preorder on ps subsets) and R[i][j] ⟺ rank(i) ≤ rank(j);
+    // that also makes R transitive, so encode_transitivity adds nothing.
+    // rank(∅) = 0 is free: ∅ is below every set and ranks can be shifted.
+    void encode_totality(z3::solver& s) {
+        if (totality == Totality::OFF) return;
+        if (!silent) std::cout << "  Encoding totality...\n";
+        int ps = vars.size();
+        if (totality == Totality::CLAUSES) {
+            for (int i = 0; i < ps; ++i) {
+                for (int j = i + 1; j < ps; ++j) {
+                    if (vars.fixed(i, j) == 1 || vars.fixed(j, i) == 1) continue;
+                    add_clause(s, {vars.lit(i, j), vars.lit(j, i)});
+                }
+            }
+            return;
+        }
+        z3::context& ctx = vars.context();
+        std::vector<z3::expr> rank;
+        for (int i = 0; i < ps; ++i) {
+            rank.push_back(ctx.bv_const(("rank" + std::to_string(i)).c_str(), vars.universe_size()));
+        }
+        s.add(rank[0] == ctx.bv_val(0, vars.universe_size()));
+        for (int i = 0; i < ps; ++i) {
+            for (int j = 0; j < ps; ++j) {
+                if (i != j) s.add(vars.get_R(i, j) == z3::ule(rank[i], rank[j]));
+            }
+        }
+    }
+
+    // Encode all common (partition-independent) axioms at once
+    void encode_common_axioms(z3::solver& s) {
+        encode_totality(s);
+        encode_transitivity(s);
         encode_monotonicity(s);
         encode_non_triviality(s);
         encode_CSTP(s);
@@ -561,7 +1432,8 @@ public:
     }
 
     // Axiom: Not Dilation (Not DLT) - Dilation does not hold for the relation R with respect to a given partition of the universe Omega where dilation means that there is a pair of subsets E and F such that for every element C in the partition, E and F are R-comparable but (E∩C) and (F∩C) are not. Thus, Not Dilation: ∀E,F: comparable(E,F) → ∃C∈partition: comparable(E∩C, F∩C) where comparable(X,Y) means R[X][Y] ∨ R[Y][X].
-    void encode_not_dilation(z3::solver& s, const std::vector<int>& partition) {
+    void encode_not_dilation(z3::solver& s, CellSpan partition) {
+        if (totality != Totality::OFF) return;   // Every E∩C, F∩C is comparable
         if (!silent) std::cout << "  Encoding Not Dilation (Not DLT)...\n";
         
         // Verify partition before encoding (silent verification)
@@ -573,28 +1445,39 @@ public:
         }
         if (union_all != full_set) return;  // Invalid partition
 
+        // The axiom is symmetric in E and F, so F ≥ E covers every pair
         for (int E = 0; E < vars.size(); ++E) {
-            for (int F = 0; F < vars.size(); ++F) {
+            for (int F = E; F < vars.size(); ++F) {
+                if (vars.fixed(E, F) == 0 && vars.fixed(F, E) == 0) continue;
                 // Build disjunction: ∃C∈partition such that (E∩C, F∩C) are comparable
-                z3::expr_vector disjuncts(vars.context());
+                clause.assign(1, nullptr);
+                bool satisfied = false;
                 for (int C : partition) {
                     int EC = BitOps::set_intersection(E, C);
                     int FC = BitOps::set_intersection(F, C);
+                    satisfied |= vars.fixed(EC, FC) == 1 || vars.fixed(FC, EC) == 1;
                     // (E∩C) and (F∩C) are R-comparable
-                    disjuncts.push_back(vars.get_R(EC, FC) || vars.get_R(FC, EC));
+                    clause.push_back(vars.lit(EC, FC));
+                    clause.push_back(vars.lit(FC, EC));
                 }
+                if (satisfied) continue;
                 
-                z3::expr E_F_comparable = vars.get_R(E, F) || vars.get_R(F, E);
-                z3::expr exists_C_comparable = z3::mk_or(disjuncts);
-                
-                // comparable(E,F) → ∃C∈partition: comparable(E∩C, F∩C)
-                s.add(z3::implies(E_F_comparable, exists_C_comparable));
+                // comparable(E,F) → ∃C∈partition: comparable(E∩C, F∩C),
+                // one clause per direction of comparable(E,F)
+                if (vars.fixed(E, F) != 0) {
+                    clause[0] = vars.lit(E, F, false);
+                    add_clause(s);
+                }
+                if (vars.fixed(F, E) != 0 && F != E) {
+                    clause[0] = vars.lit(F, E, false);
+                    add_clause(s);
+                }
             }
         }
     }
 
     // Axiom: Not Weak Dilation (Not Weak DLT) - Weak Dilation does not hold for the relation R with respect to a given partition of the universe Omega. Weak Dilation means that there is a pair of subsets E and F such that for SOME (note the difference between dilation and weak dilation) element C in the partition, E and F are R-comparable but (E∩C) and (F∩C) are not. Thus, Not Weak Dilation: ∀E,F: comparable(E,F) → ∀C∈partition: comparable(E∩C, F∩C) where comparable(X,Y) means R[X][Y] ∨ R[Y][X].
-    void encode_not_weak_dilation(z3::solver& s, const std::vector<int>& partition) {
+    void encode_not_weak_dilation(z3::solver& s, CellSpan partition) {
         if (!silent) std::cout << "  Encoding Not Dilation (Not DLT)...\n";
         
         // Verify partition before encoding
@@ -628,14 +1511,14 @@ public:
     // where [E∩I1 ≤ F∩I1] = ∪{C ∈ I1 | R[E∩C][F∩C]} 
     // and [E∩I2 ≰ F∩I2] = ∪{C ∈ I2 | ¬R[E∩C][F∩C]}
     // CK[S] = largest element in (F1 ∩ F2) that is contained in S
-    void encode_A2D(z3::solver& s, const std::vector<int>& I1, const std::vector<int>& I2) {
+    void encode_A2D(z3::solver& s, CellSpan I1, CellSpan I2) {
         if (!silent) std::cout << "  Encoding Agreeing to Disagree (A2D)...\n";
         
         int n = vars.universe_size();
         
         // Verify partitions (silent)
         int full_set = (1 << n) - 1;
-        auto check_partition = [full_set](const std::vector<int>& p) {
+        auto check_partition = [full_set](CellSpan p) {
             int u = 0;
             for (int c : p) { if (c == 0) return false; u |= c; }
             return u == full_set;
@@ -646,141 +1529,307 @@ public:
         // PHASE 1: Static Precomputation
         // ============================================
         
-        // 1.1 Generate fields
-        std::vector<int> F1 = BitOps::generate_field(I1, n);
-        std::vector<int> F2 = BitOps::generate_field(I2, n);
-        
-        // 1.2 Compute common field (set intersection of F1 and F2)
-        std::vector<int> common_field;
-        for (int g : F1) {
-            for (int h : F2) {
-                if (g == h) {
-                    common_field.push_back(g);
-                    break;
-                }
-            }
-        }
-        // Sort by cardinality descending for efficient CK computation
-        std::sort(common_field.begin(), common_field.end(), 
-            [](int a, int b) { return BitOps::cardinality(a) > BitOps::cardinality(b); });
+        std::vector<std::pair<int, int>> T = a2d_patterns(I1, I2);
         
-        // 1.3 Compute CK[S] for all S in F1 ∪ F2
-        // CK[S] = largest element in common_field that is subset of S
-        auto compute_CK = [&common_field](int S) -> int {
-            for (int G : common_field) {  // Already sorted by cardinality descending
-                if (BitOps::is_subset(G, S)) {
-                    return G;
-                }
-            }
-            return 0;  // Empty set is always in common_field
-        };
+        // ============================================
+        // PHASE 2: Build Symbolic Constraint
+        // ============================================
         
-        // 1.4 Build lookup table T = {(A, B) | A ∈ F1, B ∈ F2, CK[A] ∩ CK[B] ≠ ∅}
-        std::vector<std::pair<int, int>> T;
-        for (int A : F1) {
-            for (int B : F2) {
-                int CK_A = compute_CK(A);
-                int CK_B = compute_CK(B);
-                if (BitOps::set_intersection(CK_A, CK_B) != 0) {
-                    T.push_back({A, B});
-                }
-            }
+        z3::expr_vector big_disjuncts(vars.context());
+        if (a2d_encoding == A2DEncoding::WITNESS) {
+            encode_A2D_witness(s, I1, I2, T, big_disjuncts);
+        } else {
+            encode_A2D_expanded(I1, I2, T, big_disjuncts);
         }
         
-        if (!silent) {
-            std::cout << "    Fields: |F1|=" << F1.size() << ", |F2|=" << F2.size() 
-                      << ", |common|=" << common_field.size() << ", |T|=" << T.size() << "\n";
-        }
+        // ============================================
+        // PHASE 3: Add to Solver
+        // ============================================
         
-        // 1.5 For each A ∈ F1, find which cells compose it
-        // cells_in1[A] = {C ∈ I1 | C ⊆ A}
-        std::map<int, std::vector<int>> cells_in1;
-        for (int A : F1) {
-            for (int C : I1) {
-                if (BitOps::is_subset(C, A)) {
-                    cells_in1[A].push_back(C);
-                }
+        if (big_disjuncts.size() > 0) {
+            s.add(z3::mk_or(big_disjuncts));
+            if (!silent) {
+                std::cout << "    Added A2D constraint with " << big_disjuncts.size() << " disjuncts\n";
             }
-        }
-        
-        // 1.6 For each B ∈ F2, find which cells compose it
-        std::map<int, std::vector<int>> cells_in2;
-        for (int B : F2) {
-            for (int C : I2) {
-                if (BitOps::is_subset(C, B)) {
-                    cells_in2[B].push_back(C);
-                }
+        } else {
+            if (!silent) {
+                std::cout << "    Warning: No A2D disjuncts generated (T is empty)\n";
             }
         }
+    }
+
+    void set_a2d_encoding(A2DEncoding encoding) { a2d_encoding = encoding; }
+    void set_totality(Totality mode) { totality = mode; }
+
+private:
+    // The cell patterns A2D accepts: T = {(a, b) | CK[F1[a]] ∩ CK[F2[b]] ≠ ∅},
+    // kept as cell-index masks (cell k of I1 is in A iff bit k of a)
+    std::vector<std::pair<int, int>> a2d_patterns(CellSpan I1, CellSpan I2) {
+        int n = vars.universe_size();
         
-        // Helper to check if cell C is in the list
-        auto cell_in_list = [](int C, const std::vector<int>& list) -> bool {
-            return std::find(list.begin(), list.end(), C) != list.end();
-        };
+        // Fields: F1[a] is the union of the I1 cells in the cell-index
+        // mask a (likewise F2[b] for I2)
+        std::vector<int> F1 = BitOps::generate_field(I1, n);
+        std::vector<int> F2 = BitOps::generate_field(I2, n);
         
-        // ============================================
-        // PHASE 2: Build Symbolic Constraint
-        // ============================================
+        // CK[S] for every S: the largest element of the common field
+        // F1 ∩ F2 contained in S (common elements are CK[S] = S)
+        std::vector<int> CK = NativeFrame::common_knowledge(I1, I2, n);
+        int common_size = 0;
+        for (int S = 0; S < vars.size(); ++S) common_size += CK[S] == S;
         
-        z3::expr_vector big_disjuncts(vars.context());
+        std::vector<std::pair<int, int>> T;
+        for (int a = 0; a < static_cast<int>(F1.size()); ++a) {
+            for (int b = 0; b < static_cast<int>(F2.size()); ++b) {
+                if (CK[F1[a]] & CK[F2[b]]) T.push_back({a, b});
+            }
+        }
         
+        if (!silent) {
+            std::cout << "    Fields: |F1|=" << F1.size() << ", |F2|=" << F2.size() 
+                      << ", |common|=" << common_size << ", |T|=" << T.size() << "\n";
+        }
+        return T;
+    }
+
+    // One conjunction per (E, F, a, b): ps^2 · |T| disjuncts over the
+    // R entries of E∩C and F∩C
+    void encode_A2D_expanded(CellSpan I1, CellSpan I2, const std::vector<std::pair<int, int>>& T,
+                             z3::expr_vector& big_disjuncts) {
         for (int E = 0; E < vars.size(); ++E) {
             for (int F = 0; F < vars.size(); ++F) {
-                for (const auto& [A, B] : T) {
-                    z3::expr_vector conjuncts(vars.context());
+                for (const auto& [a, b] : T) {
+                    clause.clear();   // Conjuncts of this tuple, as borrowed literals
                     
                     // Constraint: A = [E∩I1 ≤ F∩I1]
                     // For each C ∈ I1: C ⊆ A ⟺ R[E∩C][F∩C]
-                    for (int C : I1) {
-                        int EC = BitOps::set_intersection(E, C);
-                        int FC = BitOps::set_intersection(F, C);
+                    for (size_t k = 0; k < I1.size(); ++k) {
+                        int EC = BitOps::set_intersection(E, I1[k]);
+                        int FC = BitOps::set_intersection(F, I1[k]);
                         
-                        if (cell_in_list(C, cells_in1[A])) {
+                        if ((a >> k) & 1) {
                             // C ⊆ A ⟹ must have E∩C ≤ F∩C
-                            conjuncts.push_back(vars.get_R(EC, FC));
+                            clause.push_back(vars.lit(EC, FC));
                         } else {
                             // C ⊄ A ⟹ must have E∩C ≰ F∩C
-                            conjuncts.push_back(!vars.get_R(EC, FC));
+                            clause.push_back(vars.lit(EC, FC, false));
                         }
                     }
                     
                     // Constraint: B = [E∩I2 ≰ F∩I2]
                     // For each C ∈ I2: C ⊆ B ⟺ ¬R[E∩C][F∩C]
-                    for (int C : I2) {
-                        int EC = BitOps::set_intersection(E, C);
-                        int FC = BitOps::set_intersection(F, C);
+                    for (size_t k = 0; k < I2.size(); ++k) {
+                        int EC = BitOps::set_intersection(E, I2[k]);
+                        int FC = BitOps::set_intersection(F, I2[k]);
                         
-                        if (cell_in_list(C, cells_in2[B])) {
+                        if ((b >> k) & 1) {
                             // C ⊆ B ⟹ must have E∩C ≰ F∩C
-                            conjuncts.push_back(!vars.get_R(EC, FC));
+                            clause.push_back(vars.lit(EC, FC, false));
                         } else {
                             // C ⊄ B ⟹ must have E∩C ≤ F∩C
-                            conjuncts.push_back(vars.get_R(EC, FC));
+                            clause.push_back(vars.lit(EC, FC));
                         }
                     }
                     
                     // This (E, F, A, B) tuple contributes to the disjunction
-                    if (conjuncts.size() > 0) {
-                        big_disjuncts.push_back(z3::mk_and(conjuncts));
+                    if (!clause.empty()) {
+                        big_disjuncts.push_back(z3::expr(vars.context(),
+                            Z3_mk_and(vars.context(), static_cast<unsigned>(clause.size()), clause.data())));
                     }
                 }
             }
         }
+    }
+
+    // E and F as witnesses: n Booleans each, e_x ⟺ x ∈ E. Every cell C
+    // gets a selector r_C ⟺ R[E∩C][F∩C], defined by two clauses per
+    // (X, Y) ⊆ C × C guarded on E∩C = X and F∩C = Y; T is then one
+    // conjunction per (a, b) over the selectors. Size Σ_C 4^|C| + |T|,
+    // against ps^2 · |T| expanded.
+    void encode_A2D_witness(z3::solver& s, CellSpan I1, CellSpan I2,
+                            const std::vector<std::pair<int, int>>& T, z3::expr_vector& big_disjuncts) {
+        z3::context& ctx = vars.context();
+        int n = vars.universe_size();
+        std::vector<z3::expr> e, f, not_e, not_f;
+        for (int x = 0; x < n; ++x) {
+            e.push_back(ctx.bool_const(("a2d_e" + std::to_string(x)).c_str()));
+            f.push_back(ctx.bool_const(("a2d_f" + std::to_string(x)).c_str()));
+            not_e.push_back(!e.back());
+            not_f.push_back(!f.back());
+        }
         
-        // ============================================
-        // PHASE 3: Add to Solver
-        // ============================================
+        // Selectors of I1's cells, then I2's
+        std::vector<z3::expr> r, not_r;
+        size_t selector_clauses = 0;
+        for (CellSpan partition : {I1, I2}) {
+            for (int C : partition) {
+                r.push_back(ctx.bool_const(("a2d_r" + std::to_string(r.size())).c_str()));
+                not_r.push_back(!r.back());
+                for (const auto& xs : SetTables::submasks(C)) {
+                    for (const auto& ys : SetTables::submasks(C)) {
+                        int X = xs.a, Y = ys.a;
+                        // ¬(E∩C = X ∧ F∩C = Y) as its literals, then the selector
+                        clause.clear();
+                        for (int m = C; m; m &= m - 1) {
+                            int x = __builtin_ctz(m);
+                            clause.push_back(((X >> x) & 1) ? not_e[x] : e[x]);
+                            clause.push_back(((Y >> x) & 1) ? not_f[x] : f[x]);
+                        }
+                        clause.push_back(nullptr);
+                        clause.push_back(nullptr);
+                        size_t last = clause.size() - 1;
+                        if (vars.fixed(X, Y) != 1) {
+                            // ... → (r_C → R[X][Y])
+                            clause[last - 1] = not_r.back();
+                            clause[last] = vars.lit(X, Y);
+                            add_clause(s);
+                            ++selector_clauses;
+                        }
+                        if (vars.fixed(X, Y) != 0) {
+                            // ... → (R[X][Y] → r_C)
+                            clause[last - 1] = r.back();
+                            clause[last] = vars.lit(X, Y, false);
+                            add_clause(s);
+                            ++selector_clauses;
+                        }
+                    }
+                }
+            }
+        }
         
-        if (big_disjuncts.size() > 0) {
-            s.add(z3::mk_or(big_disjuncts));
-            if (!silent) {
-                std::cout << "    Added A2D constraint with " << big_disjuncts.size() << " disjuncts\n";
+        // A = [E∩I1 ≤ F∩I1] and B = [E∩I2 ≰ F∩I2] read off the selectors
+        size_t cells1 = I1.size();
+        for (const auto& [a, b] : T) {
+            clause.clear();
+            for (size_t k = 0; k < cells1; ++k) {
+                clause.push_back(((a >> k) & 1) ? r[k] : not_r[k]);
+            }
+            for (size_t k = 0; k < I2.size(); ++k) {
+                clause.push_back(((b >> k) & 1) ? not_r[cells1 + k] : r[cells1 + k]);
             }
+            big_disjuncts.push_back(z3::expr(ctx,
+                Z3_mk_and(ctx, static_cast<unsigned>(clause.size()), clause.data())));
+        }
+        if (!silent) {
+            std::cout << "    Witness selectors: " << r.size() << " cell(s), "
+                      << selector_clauses << " clause(s)\n";
+        }
+    }
+};
+
+// ============================================================
+//  Backbone - R entries fixed by the common axioms alone
+// ============================================================
+//  Literals true in every frame satisfying the common axioms hold
+//  in every task's frames too, so they can be folded into each
+//  encoding (see FrameVariables::fix). Computed once per n on one
+//  incremental solver: each entry is checked against its value in
+//  the current model under a single assumption; a SAT answer also
+//  clears every other candidate the new model disagrees with.
+//  Cached as text: a "backbone n=N" line, then one row per subset
+//  of '1' (forced true), '0' (forced false) and '.' (free).
+// ============================================================
+
+class Backbone {
+public:
+    static constexpr int8_t FREE = -1;
+
+    static std::string default_path(int n) {
+        return "backbone_n" + std::to_string(n) + ".txt";
+    }
+
+    // Read the cache at path if it matches n, else compute and write it
+    static std::vector<int8_t> load_or_compute(int n, const std::string& path) {
+        std::vector<int8_t> fixed;
+        if (load(path, n, fixed)) {
+            std::cout << "Backbone: loaded " << path << "\n";
         } else {
-            if (!silent) {
-                std::cout << "    Warning: No A2D disjuncts generated (T is empty)\n";
+            auto start = std::chrono::steady_clock::now();
+            fixed = compute(n);
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            std::cout << "Backbone: computed in " << ms << " ms";
+            if (save(path, n, fixed)) std::cout << ", cached in " << path;
+            std::cout << "\n";
+        }
+        int ps = 1 << n, forced = 0, beyond = 0;
+        for (int e = 0; e < ps * ps; ++e) {
+            if (fixed[e] == FREE) continue;
+            ++forced;
+            if (!BitOps::is_subset(e / ps, e % ps)) ++beyond;
+        }
+        std::cout << "Backbone: " << forced << " of " << ps * ps << " entries fixed ("
+                  << beyond << " beyond monotonicity)\n";
+        return fixed;
+    }
+
+    static std::vector<int8_t> compute(int n) {
+        z3::context ctx;
+        FrameVariables vars(ctx, n, /*silent=*/true);
+        AxiomEncoder encoder(vars, /*silent=*/true);
+        z3::solver solver(ctx, "QF_FD");
+        encoder.encode_common_axioms(solver);
+
+        int ps = vars.size();
+        std::vector<int8_t> fixed(ps * ps, FREE);
+        if (solver.check() != z3::sat) return fixed;
+
+        // candidate[e]: value of entry e in every model seen so far, or FREE
+        std::vector<int8_t> candidate(ps * ps);
+        auto value = [&vars, ps](const z3::model& m, int e) -> int8_t {
+            return m.eval(vars.get_R(e / ps, e % ps), true).is_true();
+        };
+        z3::model model = solver.get_model();
+        for (int e = 0; e < ps * ps; ++e) candidate[e] = value(model, e);
+
+        for (int e = 0; e < ps * ps; ++e) {
+            if (candidate[e] == FREE) continue;
+            z3::expr lit = vars.get_R(e / ps, e % ps);
+            z3::expr_vector flipped(ctx);
+            flipped.push_back(candidate[e] ? !lit : lit);
+            if (solver.check(flipped) == z3::unsat) {
+                fixed[e] = candidate[e];
+                solver.add(candidate[e] ? lit : !lit);
+            } else {
+                model = solver.get_model();
+                for (int f = e; f < ps * ps; ++f) {
+                    if (candidate[f] != FREE && value(model, f) != candidate[f]) candidate[f] = FREE;
+                }
+            }
+        }
+        return fixed;
+    }
+
+private:
+    static bool load(const std::string& path, int n, std::vector<int8_t>& fixed) {
+        std::ifstream in(path);
+        std::string line;
+        if (!std::getline(in, line) || line != "backbone n=" + std::to_string(n)) return false;
+        int ps = 1 << n;
+        fixed.assign(ps * ps, FREE);
+        for (int i = 0; i < ps; ++i) {
+            if (!std::getline(in, line) || static_cast<int>(line.size()) != ps) return false;
+            for (int j = 0; j < ps; ++j) {
+                if (line[j] == '1' || line[j] == '0') fixed[i * ps + j] = line[j] == '1';
+                else if (line[j] != '.') return false;
+            }
+        }
+        return true;
+    }
+
+    static bool save(const std::string& path, int n, const std::vector<int8_t>& fixed) {
+        std::ofstream out(path);
+        if (!out) return false;
+        int ps = 1 << n;
+        out << "backbone n=" << n << "\n";
+        for (int i = 0; i < ps; ++i) {
+            for (int j = 0; j < ps; ++j) {
+                int8_t v = fixed[i * ps + j];
+                out << (v == FREE ? '.' : v ? '1' : '0');
             }
+            out << "\n";
         }
+        return static_cast<bool>(out);
     }
 };
 
@@ -788,11 +1837,20 @@ public:
 //  Task - Represents a single search task (partition pair)
 // ============================================================
 
+//  Compact POD: partitions are ids into the shared PartitionTable,
+//  so tasks copy without allocation and serialize as raw bytes.
+
 struct Task {
-    int id;
-    std::vector<int> partition1;  // I1
-    std::vector<int> partition2;  // I2
+    int32_t id;
+    uint16_t partition1;  // I1 (PartitionTable id)
+    uint16_t partition2;  // I2 (PartitionTable id)
+
+    static Task from_index(const PartitionTable& table, int k) {
+        auto ij = table.pair_at(k);
+        return Task{k, static_cast<uint16_t>(ij.first), static_cast<uint16_t>(ij.second)};
+    }
 };
+static_assert(std::is_trivially_copyable<Task>::value, "Task must stay a POD");
 
 // ============================================================
 //  TaskQueue - Thread-safe work queue
@@ -805,9 +1863,9 @@ class TaskQueue {
     bool finished = false;
 
 public:
-    void push(Task t) {
+    void push(const Task& t) {
         std::lock_guard<std::mutex> lock(mtx);
-        tasks.push(std::move(t));
+        tasks.push(t);
         cv.notify_one();
     }
     
@@ -815,7 +1873,7 @@ public:
         std::unique_lock<std::mutex> lock(mtx);
         cv.wait(lock, [this]() { return !tasks.empty() || finished; });
         if (tasks.empty()) return false;
-        t = std::move(tasks.front());
+        t = tasks.front();
         tasks.pop();
         return true;
     }
@@ -901,6 +1959,11 @@ class SolutionCollector {
     std::mutex mtx;
     std::vector<SolutionRecord> solutions;
     int universe_size_stored = 0;
+    
+    // Distinct collected frames as native rows, ps rows per frame
+    // (n <= NativeFrame::MAX_UNIVERSE only), for model reuse
+    std::vector<NativeFrame::Row> frame_rows;
+    std::atomic<int> reused{0};
 
 public:
     void add_solution(int task_id, const Task& task, 
@@ -918,10 +1981,48 @@ public:
         record.minimal_generator_count = static_cast<int>(minimal.size());
         
         std::lock_guard<std::mutex> lock(mtx);
+        if (universe_size <= NativeFrame::MAX_UNIVERSE) {
+            std::vector<NativeFrame::Row> rows = NativeFrame::from_matrix(matrix);
+            size_t ps = rows.size();
+            bool known = false;
+            for (size_t f = 0; f < frame_rows.size() && !known; f += ps) {
+                known = std::equal(rows.begin(), rows.end(), frame_rows.begin() + f);
+            }
+            if (!known) frame_rows.insert(frame_rows.end(), rows.begin(), rows.end());
+        }
         solutions.push_back(std::move(record));
         universe_size_stored = universe_size;
     }
     
+    // Model reuse: every collected frame already satisfies the common
+    // axioms, so it witnesses a new pair (I1, I2) if it also passes
+    // Not-Dilation for both partitions and Agreeing to Disagree.
+    // Returns the first such frame's matrix, or an empty matrix.
+    std::vector<std::vector<bool>> find_witness(const FrameKernels& kernels, CellSpan I1, CellSpan I2,
+                                                int universe_size) {
+        if (universe_size > NativeFrame::MAX_UNIVERSE) return {};
+        std::vector<NativeFrame::Row> rows;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            rows = frame_rows;
+        }
+        int ps = 1 << universe_size;
+        std::vector<int> ck;
+        for (size_t f = 0; f < rows.size(); f += ps) {
+            const NativeFrame::Row* frame = rows.data() + f;
+            if (!kernels.not_dilation(frame, I1) || !kernels.not_dilation(frame, I2)) continue;
+            if (ck.empty()) ck = NativeFrame::common_knowledge(I1, I2, universe_size);
+            if (kernels.agreeing_to_disagree(frame, I1, I2, ck)) {
+                ++reused;
+                return NativeFrame::to_matrix(frame, ps);
+            }
+        }
+        return {};
+    }
+    
+    // Tasks answered by find_witness
+    int reuse_count() const { return reused.load(); }
+    
     size_t count() const {
         return solutions.size();
     }
@@ -934,6 +2035,19 @@ public:
         return universe_size_stored;
     }
     
+    // Find the solution with the fewest extension entries (branch-and-bound objective)
+    const SolutionRecord* find_fewest_extensions_solution() const {
+        if (solutions.empty()) return nullptr;
+        
+        const SolutionRecord* best = &solutions[0];
+        for (const auto& sol : solutions) {
+            if (sol.extension_count < best->extension_count) {
+                best = &sol;
+            }
+        }
+        return best;
+    }
+    
     // Find the solution with the smallest minimal_generator_count
     const SolutionRecord* find_minimal_solution() const {
         if (solutions.empty()) return nullptr;
@@ -949,151 +2063,2673 @@ public:
 };
 
 // ============================================================
-//  SolverWorker - Worker thread that processes tasks
+//  CpuTopology - CPU/NUMA layout from /sys and worker pinning
+// ============================================================
+//  Only CPUs in the process affinity mask are considered, so the
+//  placement respects taskset/cgroup restrictions. A pinned worker
+//  also switches to the local-node memory policy; since its Z3
+//  context is created after pinning, the context's working set is
+//  allocated on the worker's own node.
 // ============================================================
 
-class SolverWorker {
-    int worker_id;
-    int universe_size;
-    TaskQueue& queue;
-    GlobalStopFlag& stop_flag;
-    std::atomic<int>& tasks_completed;
-    std::mutex& io_mutex;
-    
-    // 1 hour timeout per task - drop and move on if exceeded
-    static constexpr unsigned int SOLVER_TIMEOUT_MS = 3600000;
+class CpuTopology {
+public:
+    struct Cpu {
+        int id;
+        int core;       // Physical core id within the package
+        int package;    // Socket
+        int node;       // NUMA node
+    };
+
+private:
+    std::vector<Cpu> cpus;
+    int num_nodes = 1;
+
+    static int read_int_file(const std::string& path, int fallback) {
+        std::ifstream in(path);
+        int value;
+        return (in >> value) ? value : fallback;
+    }
+
+    // Parse a /sys cpulist such as "0-3,8-11"
+    static std::vector<int> parse_cpulist(const std::string& list) {
+        std::vector<int> ids;
+        std::stringstream ss(list);
+        std::string range;
+        while (std::getline(ss, range, ',')) {
+            if (range.empty()) continue;
+            size_t dash = range.find('-');
+            int lo = std::atoi(range.substr(0, dash).c_str());
+            int hi = dash == std::string::npos ? lo : std::atoi(range.substr(dash + 1).c_str());
+            for (int c = lo; c <= hi; ++c) ids.push_back(c);
+        }
+        return ids;
+    }
 
 public:
-    SolverWorker(int id, int n, TaskQueue& q, GlobalStopFlag& sf, 
-                 std::atomic<int>& tc, std::mutex& iom)
-        : worker_id(id), universe_size(n), queue(q), stop_flag(sf),
-          tasks_completed(tc), io_mutex(iom) {}
-    
-    void run() {
-        // Create thread-local Z3 context and variables
-        z3::context local_ctx;
-        FrameVariables local_vars(local_ctx, universe_size, /*silent=*/true);
-        AxiomEncoder encoder(local_vars, /*silent=*/true);
-        
-        Task task;
-        while (!stop_flag.should_stop() && queue.try_pop(task)) {
-            // Create fresh solver for this task
-            z3::solver solver(local_ctx);
-            
-            // Set timeout - drop and move on after this time
-            z3::params p(local_ctx);
-            p.set("timeout", SOLVER_TIMEOUT_MS);
-            solver.set(p);
-            
-            // Encode common axioms
-            encoder.encode_common_axioms(solver);
-            
-            // Encode partition-specific axioms
-            encoder.encode_not_dilation(solver, task.partition1);
-            encoder.encode_not_dilation(solver, task.partition2);
-            encoder.encode_A2D(solver, task.partition1, task.partition2);
-            
-            // Solve (single attempt with long timeout)
-            z3::check_result result = solver.check();
-            
-            // Check for early termination by another worker
-            if (stop_flag.should_stop()) {
-                return;
-            }
-            
-            if (result == z3::sat) {
-                // Extract matrix before reporting (model is context-dependent)
-                z3::model m = solver.get_model();
-                int ps = local_vars.size();
-                std::vector<std::vector<bool>> matrix(ps, std::vector<bool>(ps));
-                for (int i = 0; i < ps; ++i) {
-                    for (int j = 0; j < ps; ++j) {
-                        matrix[i][j] = m.eval(local_vars.get_R(i, j)).is_true();
-                    }
-                }
-                
-                stop_flag.report_solution(task.id, task, matrix, universe_size);
-                
-                {
-                    std::lock_guard<std::mutex> lock(io_mutex);
-                    std::cout << "[Worker " << worker_id << "] FOUND SOLUTION for task " 
-                              << task.id << "!\n";
+    static CpuTopology detect() {
+        CpuTopology topo;
+
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        sched_getaffinity(0, sizeof(allowed), &allowed);
+
+        // NUMA node of each CPU
+        std::map<int, int> node_of_cpu;
+        const std::string node_root = "/sys/devices/system/node/";
+        if (DIR* dir = opendir(node_root.c_str())) {
+            while (dirent* entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (name.compare(0, 4, "node") != 0 || name.size() < 5 ||
+                    !std::isdigit(static_cast<unsigned char>(name[4]))) {
+                    continue;
                 }
-                return;
-            }
-            
-            // Task completed (UNSAT or TIMEOUT) - move on to next task
-            int completed = ++tasks_completed;
-            if (!stop_flag.should_stop()) {
-                std::lock_guard<std::mutex> lock(io_mutex);
-                std::cout << "[Worker " << worker_id << "] Task " << task.id 
-                          << " completed (" << (result == z3::unsat ? "UNSAT" : "TIMEOUT")
-                          << "). Progress: " << completed << " tasks done.\n";
+                int node = std::atoi(name.c_str() + 4);
+                std::ifstream in(node_root + name + "/cpulist");
+                std::string list;
+                std::getline(in, list);
+                for (int c : parse_cpulist(list)) node_of_cpu[c] = node;
+                topo.num_nodes = std::max(topo.num_nodes, node + 1);
             }
+            closedir(dir);
+        }
+
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (!CPU_ISSET(c, &allowed)) continue;
+            std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(c) + "/topology/";
+            Cpu cpu;
+            cpu.id = c;
+            cpu.core = read_int_file(base + "core_id", c);
+            cpu.package = read_int_file(base + "physical_package_id", 0);
+            cpu.node = node_of_cpu.count(c) ? node_of_cpu[c] : 0;
+            topo.cpus.push_back(cpu);
         }
+        return topo;
     }
-};
 
-// ============================================================
-//  ExhaustiveWorker - Worker that processes ALL tasks (no early stop)
-// ============================================================
+    size_t size() const { return cpus.size(); }
+    int nodes() const { return num_nodes; }
 
-class ExhaustiveWorker {
-    int worker_id;
-    int universe_size;
-    TaskQueue& queue;
-    SolutionCollector& collector;
-    std::atomic<int>& tasks_completed;
-    std::atomic<int>& tasks_total;
-    std::mutex& io_mutex;
-    
-    // 1 hour timeout per task - drop and move on if exceeded
-    static constexpr unsigned int SOLVER_TIMEOUT_MS = 3600000;
+    int node_of(int cpu_id) const {
+        for (const auto& c : cpus) {
+            if (c.id == cpu_id) return c.node;
+        }
+        return 0;
+    }
 
-public:
-    ExhaustiveWorker(int id, int n, TaskQueue& q, SolutionCollector& sc,
-                     std::atomic<int>& tc, std::atomic<int>& tt, std::mutex& iom)
-        : worker_id(id), universe_size(n), queue(q), collector(sc),
-          tasks_completed(tc), tasks_total(tt), io_mutex(iom) {}
-    
-    void run() {
+    // Physical cores available (SMT siblings counted once)
+    int physical_cores() const {
+        std::vector<std::pair<int, int>> seen;
+        for (const auto& c : cpus) {
+            std::pair<int, int> key{c.package, c.core};
+            if (std::find(seen.begin(), seen.end(), key) == seen.end()) seen.push_back(key);
+        }
+        return static_cast<int>(seen.size());
+    }
+
+    // CPU ids for `count` workers: round-robin over NUMA nodes; within a
+    // node one hardware thread per physical core first, then SMT siblings.
+    // Wraps around when there are more workers than CPUs.
+    std::vector<int> placement(int count) const {
+        std::vector<std::vector<int>> per_node(num_nodes);
+        for (int node = 0; node < num_nodes; ++node) {
+            std::vector<Cpu> local;
+            for (const auto& c : cpus) {
+                if (c.node == node) local.push_back(c);
+            }
+            std::sort(local.begin(), local.end(), [](const Cpu& a, const Cpu& b) {
+                if (a.package != b.package) return a.package < b.package;
+                if (a.core != b.core) return a.core < b.core;
+                return a.id < b.id;
+            });
+            std::vector<int> primary, sibling;
+            for (size_t i = 0; i < local.size(); ++i) {
+                bool first_of_core = i == 0 || local[i].core != local[i - 1].core ||
+                                     local[i].package != local[i - 1].package;
+                (first_of_core ? primary : sibling).push_back(local[i].id);
+            }
+            per_node[node] = primary;
+            per_node[node].insert(per_node[node].end(), sibling.begin(), sibling.end());
+        }
+
+        std::vector<int> order;
+        for (size_t depth = 0; order.size() < cpus.size(); ++depth) {
+            for (const auto& node_cpus : per_node) {
+                if (depth < node_cpus.size()) order.push_back(node_cpus[depth]);
+            }
+        }
+
+        std::vector<int> result;
+        for (int w = 0; w < count && !order.empty(); ++w) {
+            result.push_back(order[w % order.size()]);
+        }
+        return result;
+    }
+
+    // Pin the calling thread to one CPU and prefer node-local memory
+    static bool pin_current_thread(int cpu_id) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu_id, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) return false;
+        // Best effort: not all kernels/containers permit set_mempolicy
+        syscall(SYS_set_mempolicy, MPOL_LOCAL, nullptr, 0);
+        return true;
+    }
+
+    void print_placement(const std::vector<int>& cpu_ids, const char* label) const {
+        std::cout << "CPU topology: " << cpus.size() << " CPU(s), " << physical_cores()
+                  << " physical core(s), " << num_nodes << " NUMA node(s)\n";
+        for (size_t w = 0; w < cpu_ids.size(); ++w) {
+            std::cout << "  " << label << " " << w << " -> CPU " << cpu_ids[w]
+                      << " (node " << node_of(cpu_ids[w]) << ")\n";
+        }
+    }
+};
+
+// ============================================================
+//  TaskResult - Outcome of solving one task
+// ============================================================
+//  Context-independent: the model is extracted into a plain
+//  boolean matrix so results can cross threads and processes.
+// ============================================================
+
+enum class TaskStatus : uint8_t {
+    UNSAT = 0,
+    SAT = 1,
+    TIMEOUT = 2,
+    CRASHED = 3,   // Worker process died while holding the task
+    MEMOUT = 4,    // Worker hit its memory limit
+    PRUNED = 5     // Branch-and-bound: cannot beat the incumbent
+};
+
+inline const char* status_name(TaskStatus status) {
+    switch (status) {
+        case TaskStatus::UNSAT:   return "UNSAT";
+        case TaskStatus::SAT:     return "SAT";
+        case TaskStatus::TIMEOUT: return "TIMEOUT";
+        case TaskStatus::CRASHED: return "CRASHED";
+        case TaskStatus::MEMOUT:  return "MEMOUT";
+        case TaskStatus::PRUNED:  return "PRUNED";
+    }
+    return "UNKNOWN";
+}
+
+struct TaskResult {
+    Task task;
+    TaskStatus status = TaskStatus::UNSAT;
+    std::vector<std::vector<bool>> matrix;  // Filled only when SAT
+};
+
+// ============================================================
+//  RecordIO - Binary result record format
+// ============================================================
+//  One record per task: a fixed 12-byte header (the POD Task,
+//  status, universe size) followed, for SAT results only, by the
+//  relation matrix bit-packed row-major in ceil(ps*ps/8) bytes.
+//  Used on worker pipes and sockets and in result files.
+// ============================================================
+
+namespace RecordIO {
+
+    struct RecordHeader {
+        Task task;
+        uint8_t status;
+        uint8_t universe_size;
+        uint16_t reserved;
+    };
+    static_assert(sizeof(RecordHeader) == 12, "RecordHeader layout is part of the format");
+
+    inline size_t matrix_bytes(int universe_size) {
+        size_t ps = size_t(1) << universe_size;
+        return (ps * ps + 7) / 8;
+    }
+
+    // Write exactly len bytes; false on error (e.g. peer gone)
+    inline bool write_all(int fd, const void* buf, size_t len) {
+        const char* p = static_cast<const char*>(buf);
+        while (len > 0) {
+            ssize_t w = ::write(fd, p, len);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += w;
+            len -= static_cast<size_t>(w);
+        }
+        return true;
+    }
+
+    // Read exactly len bytes; false on EOF or error
+    inline bool read_all(int fd, void* buf, size_t len) {
+        char* p = static_cast<char*>(buf);
+        while (len > 0) {
+            ssize_t r = ::read(fd, p, len);
+            if (r < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            if (r == 0) return false;
+            p += r;
+            len -= static_cast<size_t>(r);
+        }
+        return true;
+    }
+
+    // Serialize a result into a contiguous byte buffer
+    inline void encode(const TaskResult& result, int universe_size, std::vector<uint8_t>& out) {
+        RecordHeader header{result.task, static_cast<uint8_t>(result.status),
+                            static_cast<uint8_t>(universe_size), 0};
+        out.assign(reinterpret_cast<const uint8_t*>(&header),
+                   reinterpret_cast<const uint8_t*>(&header) + sizeof(header));
+        if (result.status != TaskStatus::SAT) return;
+
+        int ps = 1 << universe_size;
+        size_t base = out.size();
+        out.resize(base + matrix_bytes(universe_size), 0);
+        for (int i = 0; i < ps; ++i) {
+            for (int j = 0; j < ps; ++j) {
+                if (result.matrix[i][j]) {
+                    size_t bit = static_cast<size_t>(i) * ps + j;
+                    out[base + bit / 8] |= static_cast<uint8_t>(1u << (bit % 8));
+                }
+            }
+        }
+    }
+
+    inline bool write_record(int fd, const TaskResult& result, int universe_size) {
+        std::vector<uint8_t> buf;
+        encode(result, universe_size, buf);
+        return write_all(fd, buf.data(), buf.size());
+    }
+
+    // Read one record; false on EOF, short read or malformed header
+    inline bool read_record(int fd, TaskResult& result, int* universe_size_out = nullptr) {
+        RecordHeader header;
+        if (!read_all(fd, &header, sizeof(header))) return false;
+        if (header.universe_size < 1 || header.universe_size > 7 ||
+            header.status > static_cast<uint8_t>(TaskStatus::PRUNED)) {
+            return false;
+        }
+        result.task = header.task;
+        result.status = static_cast<TaskStatus>(header.status);
+        result.matrix.clear();
+        if (universe_size_out) *universe_size_out = header.universe_size;
+        if (result.status != TaskStatus::SAT) return true;
+
+        int ps = 1 << header.universe_size;
+        std::vector<uint8_t> bits(matrix_bytes(header.universe_size));
+        if (!read_all(fd, bits.data(), bits.size())) return false;
+        result.matrix.assign(ps, std::vector<bool>(ps));
+        for (int i = 0; i < ps; ++i) {
+            for (int j = 0; j < ps; ++j) {
+                size_t bit = static_cast<size_t>(i) * ps + j;
+                result.matrix[i][j] = (bits[bit / 8] >> (bit % 8)) & 1;
+            }
+        }
+        return true;
+    }
+}
+
+// ============================================================
+//  ResultFile - On-disk stream of RecordIO records
+// ============================================================
+//  A small header (universe size, shard and task range) followed
+//  by one record per finished task, appended as tasks complete so
+//  an interrupted run keeps everything written so far. Readers
+//  stop at the first truncated record.
+// ============================================================
+
+class ResultFile {
+public:
+    struct Header {
+        uint32_t magic;
+        int32_t universe_size;
+        int32_t shard_index;
+        int32_t shard_count;
+        int32_t task_begin;     // Task id range covered: [task_begin, task_end)
+        int32_t task_end;
+    };
+    static constexpr uint32_t MAGIC = 0x46465231;  // "FFR1"
+
+private:
+    int fd = -1;
+    int universe_size = 0;
+    std::mutex mtx;
+
+public:
+    ~ResultFile() {
+        if (fd >= 0) close(fd);
+    }
+
+    bool open_for_write(const std::string& path, const Header& header) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        universe_size = header.universe_size;
+        return RecordIO::write_all(fd, &header, sizeof(header));
+    }
+
+    // Thread-safe; each record is written with a single write call
+    bool append(const TaskResult& result) {
+        std::vector<uint8_t> buf;
+        RecordIO::encode(result, universe_size, buf);
+        std::lock_guard<std::mutex> lock(mtx);
+        return RecordIO::write_all(fd, buf.data(), buf.size());
+    }
+
+    static bool read(const std::string& path, Header& header, std::vector<TaskResult>& results) {
+        int in = ::open(path.c_str(), O_RDONLY);
+        if (in < 0) return false;
+        bool ok = RecordIO::read_all(in, &header, sizeof(header)) && header.magic == MAGIC;
+        if (ok) {
+            TaskResult result;
+            int n = 0;
+            while (RecordIO::read_record(in, result, &n) && n == header.universe_size) {
+                results.push_back(std::move(result));
+            }
+        }
+        close(in);
+        return ok;
+    }
+};
+
+// ============================================================
+//  ModelStream - Text sink for enumerated frames
+// ============================================================
+//  One line per model: task id, model index within the task,
+//  extension count, then the rows of R as hex bitmasks (bit j of
+//  row i is R[i][j]). Each task ends with a '#' line giving its
+//  model count and whether enumeration finished. Lines are flushed
+//  as written, so a long run can be inspected while in progress.
+// ============================================================
+
+class ModelStream {
+    std::ofstream out;
+    std::mutex mtx;
+    std::atomic<uint64_t> total{0};
+
+public:
+    bool open(const std::string& path, int universe_size, bool modulo_symmetry) {
+        out.open(path, std::ios::out | std::ios::trunc);
+        if (!out) return false;
+        out << "# frames n=" << universe_size
+            << (modulo_symmetry ? " modulo pair automorphisms" : "") << "\n"
+            << "# task model extensions rows(hex)...\n";
+        out.flush();
+        return static_cast<bool>(out);
+    }
+
+    void write_model(int task_id, uint64_t index, int extensions,
+                     const std::vector<std::vector<bool>>& matrix) {
+        std::string line = std::to_string(task_id) + " " + std::to_string(index) + " " +
+                           std::to_string(extensions);
+        for (const auto& row : matrix) {
+            line += ' ';
+            line += row_hex(row);
+        }
+        line += '\n';
+        std::lock_guard<std::mutex> lock(mtx);
+        out << line;
+        out.flush();
+        ++total;
+    }
+
+    // outcome: "complete", "limit" or "timeout"
+    void finish_task(int task_id, uint64_t count, const char* outcome) {
+        std::lock_guard<std::mutex> lock(mtx);
+        out << "# task " << task_id << ": " << count << " model(s), " << outcome << "\n";
+        out.flush();
+    }
+
+    uint64_t models_written() const { return total.load(); }
+
+private:
+    // Most significant hex digit first, so bit j of the row is bit j of the number
+    static std::string row_hex(const std::vector<bool>& row) {
+        static const char digits[] = "0123456789abcdef";
+        int width = (static_cast<int>(row.size()) + 3) / 4;
+        std::string hex(width, '0');
+        for (size_t j = 0; j < row.size(); ++j) {
+            if (!row[j]) continue;
+            char& d = hex[width - 1 - j / 4];
+            d = digits[(d <= '9' ? d - '0' : d - 'a' + 10) | (1 << (j % 4))];
+        }
+        return hex;
+    }
+};
+
+// ============================================================
+//  IncumbentBound - Shared best objective for branch-and-bound
+// ============================================================
+//  Lock-free minimum over all workers of the best extension count
+//  found so far; tasks read it as an upper bound before solving.
+// ============================================================
+
+class IncumbentBound {
+    std::atomic<int> best{std::numeric_limits<int>::max()};
+
+public:
+    static constexpr int NONE = std::numeric_limits<int>::max();
+
+    int get() const { return best.load(std::memory_order_acquire); }
+
+    // Lower the bound to value; true if value improved it
+    bool offer(int value) {
+        int current = best.load(std::memory_order_acquire);
+        while (value < current) {
+            if (best.compare_exchange_weak(current, value, std::memory_order_acq_rel)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// ============================================================
+//  CoreFacts - Shared UNSAT facts from axiom-group cores
+// ============================================================
+//  Workers solving with --core-pruning guard each partition group
+//  (Not-Dilation of I1, of I2, A2D) by an assumption literal. An
+//  UNSAT core without A2D means Not-Dilation alone is to blame:
+//  either for a single partition, which rules out every pair that
+//  contains it, or for the two partitions together. Workers consult
+//  these facts before solving and skip dominated tasks.
+// ============================================================
+
+class CoreFacts {
+public:
+    enum : uint8_t { UNKNOWN, FEASIBLE, INFEASIBLE };  // Common axioms + Not-Dilation(P)
+
+private:
+    std::unique_ptr<std::atomic<uint8_t>[]> partition_state;
+    std::mutex mtx;
+    std::set<std::pair<int, int>> infeasible_pairs;   // (min, max) partition ids
+    std::atomic<int> pruned{0};
+    std::atomic<int> infeasible_partitions{0};
+
+public:
+    explicit CoreFacts(int num_partitions)
+        : partition_state(new std::atomic<uint8_t>[num_partitions]) {
+        for (int p = 0; p < num_partitions; ++p) partition_state[p].store(UNKNOWN);
+    }
+
+    uint8_t state(int p) const { return partition_state[p].load(std::memory_order_acquire); }
+
+    void set_state(int p, uint8_t st) {
+        if (partition_state[p].exchange(st, std::memory_order_acq_rel) != INFEASIBLE &&
+            st == INFEASIBLE) {
+            ++infeasible_partitions;
+        }
+    }
+
+    void add_infeasible_pair(int p, int q) {
+        std::lock_guard<std::mutex> lock(mtx);
+        infeasible_pairs.insert({std::min(p, q), std::max(p, q)});
+    }
+
+    // True if the facts already prove task UNSAT; counts it as pruned
+    bool dominated(const Task& task) {
+        bool known = state(task.partition1) == INFEASIBLE || state(task.partition2) == INFEASIBLE;
+        if (!known) {
+            std::lock_guard<std::mutex> lock(mtx);
+            known = infeasible_pairs.count({std::min(task.partition1, task.partition2),
+                                            std::max(task.partition1, task.partition2)}) > 0;
+        }
+        if (known) ++pruned;
+        return known;
+    }
+
+    int pruned_count() const { return pruned.load(); }
+    int infeasible_partition_count() const { return infeasible_partitions.load(); }
+    size_t infeasible_pair_count() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return infeasible_pairs.size();
+    }
+};
+
+// ============================================================
+//  Totalizer - Incremental unary counter over Boolean literals
+// ============================================================
+//  Bailleux-Boufkhad totalizer, k-bounded: a binary tree whose
+//  nodes hold unary counts of their leaves, outputs capped at
+//  `cap` (larger counts saturate at the top output). Only the
+//  upward implications are encoded, which is all an upper bound
+//  needs. "count < k" is the single literal !outputs[k-1], passed
+//  as an assumption so one solver can tighten k repeatedly.
+// ============================================================
+
+class Totalizer {
+    z3::context& ctx;
+    std::string prefix;
+    unsigned cap;
+    unsigned next_var = 0;
+    z3::expr_vector outputs;   // outputs[k-1] <=> at least k inputs are true (k <= cap)
+
+public:
+    Totalizer(z3::solver& s, const z3::expr_vector& inputs, unsigned bound_cap, const std::string& name)
+        : ctx(s.ctx()), prefix(name), cap(bound_cap > 0 ? bound_cap : 1), outputs(s.ctx()) {
+        if (inputs.size() > 0) outputs = build(s, inputs, 0, inputs.size());
+    }
+
+    unsigned size() const { return outputs.size(); }
+
+    // Assumption literal for "fewer than k inputs are true", 1 <= k <= cap
+    z3::expr less_than(unsigned k) const {
+        if (k == 0 || k > outputs.size()) return ctx.bool_val(k > outputs.size());
+        return !outputs[k - 1];
+    }
+
+private:
+    z3::expr fresh() {
+        std::string name = prefix + "_" + std::to_string(next_var++);
+        return ctx.bool_const(name.c_str());
+    }
+
+    z3::expr_vector build(z3::solver& s, const z3::expr_vector& inputs, unsigned lo, unsigned hi) {
+        if (hi - lo == 1) {
+            z3::expr_vector leaf(ctx);
+            leaf.push_back(inputs[lo]);
+            return leaf;
+        }
+        unsigned mid = lo + (hi - lo) / 2;
+        z3::expr_vector left = build(s, inputs, lo, mid);
+        z3::expr_vector right = build(s, inputs, mid, hi);
+
+        unsigned width = std::min(left.size() + right.size(), cap);
+        z3::expr_vector out(ctx);
+        for (unsigned k = 0; k < width; ++k) out.push_back(fresh());
+
+        // left >= i and right >= j  ->  out >= min(i + j, width)
+        for (unsigned i = 0; i <= left.size(); ++i) {
+            for (unsigned j = 0; j <= right.size(); ++j) {
+                if (i + j == 0) continue;
+                unsigned t = std::min(i + j, width);
+                z3::expr_vector clause(ctx);
+                if (i > 0) clause.push_back(!left[i - 1]);
+                if (j > 0) clause.push_back(!right[j - 1]);
+                clause.push_back(out[t - 1]);
+                s.add(z3::mk_or(clause));
+                // Once i alone saturates, larger j add nothing new
+                if (i + j >= width && j > 0) break;
+            }
+        }
+        return out;
+    }
+};
+
+// ============================================================
+//  FramePropagator - Native unit propagation over R entries
+// ============================================================
+//  A partial relation as bit rows (known-true and known-false per
+//  subset) plus a trail for undo. Monotonicity and non-triviality
+//  are fixed at the root, transitivity propagates along the rows,
+//  and CSTP / strict CSTP (and Not-Dilation for any partitions
+//  given) are clauses with two watched literals. Base of the
+//  native engines below.
+// ============================================================
+
+class FramePropagator {
+protected:
+    using Row = NativeFrame::Row;
+    enum { FALSE = 0, TRUE = 1, OPEN = -1 };
+
+    int ps;
+    std::vector<Row> T, F;                      // Known-true / known-false bits per row
+    std::vector<int> trail;                     // Assigned literals: entry * 2 + negated
+    size_t qhead = 0;
+    bool root_conflict = false;
+
+    std::vector<int> clause_lits;
+    std::vector<uint32_t> clause_start;         // Clause c is lits[start[c]..start[c+1])
+    std::vector<std::vector<int>> watches;      // Literal -> clauses to visit when it turns false
+    std::vector<std::array<int, 3>> triangles;  // Entries (ij, jk, ik): R[i][j] ∧ R[j][k] → R[i][k]
+
+    // Implication graph for conflict analysis. An entry implied by
+    // clause c has reason_clause c; one implied by transitivity has
+    // reason_clause -1 and the two true literals it followed from in
+    // reason_ante; decisions and root facts have neither.
+    int decision_level = 0;
+    std::vector<int> level;
+    std::vector<int> reason_clause;
+    std::vector<std::array<int, 2>> reason_ante;
+    std::vector<int> conflict;                  // Literals of the violated clause (all false)
+    int conflict_clause = -1;                   // Its clause index, or -1 for transitivity
+    size_t common_clauses = 0;                  // Clauses [0, common_clauses) are CSTP / strict CSTP
+
+    // Common axioms plus Not-Dilation for each of `partitions`
+    FramePropagator(int universe_size, const std::vector<CellSpan>& partitions)
+        : ps(1 << universe_size), T(ps, 0), F(ps, 0), watches(2 * ps * ps),
+          level(ps * ps, 0), reason_clause(ps * ps, -1), reason_ante(ps * ps, {-1, -1}) {
+        build(partitions);
+    }
+
+    static int lit(int e, bool negated) { return 2 * e + (negated ? 1 : 0); }
+
+    int value(int e) const {
+        Row bit = Row(1) << (e % ps);
+        if (T[e / ps] & bit) return TRUE;
+        if (F[e / ps] & bit) return FALSE;
+        return OPEN;
+    }
+
+    int lit_value(int l) const {
+        int v = value(l >> 1);
+        return v == OPEN ? OPEN : (l & 1) ? 1 - v : v;
+    }
+
+    // Decision or root fact
+    bool assign(int i, int j, bool v) {
+        return imply(i, j, v, -1, -1);
+    }
+
+    // R[i][j] = v forced by true literals a1, a2 (clause v ∨ ¬a1 ∨ ¬a2)
+    bool imply(int i, int j, bool v, int a1, int a2) {
+        Row bit = Row(1) << j;
+        int e = i * ps + j;
+        if ((v ? F[i] : T[i]) & bit) {
+            conflict_clause = -1;
+            conflict.clear();
+            conflict.push_back(lit(e, !v));
+            if (a1 >= 0) conflict.push_back(a1 ^ 1);
+            if (a2 >= 0) conflict.push_back(a2 ^ 1);
+            return false;
+        }
+        Row& row = v ? T[i] : F[i];
+        if (row & bit) return true;
+        row |= bit;
+        level[e] = decision_level;
+        reason_clause[e] = -1;
+        reason_ante[e] = {a1, a2};
+        trail.push_back(lit(e, !v));
+        return true;
+    }
+
+    void undo(size_t mark) {
+        while (trail.size() > mark) {
+            int e = trail.back() >> 1;
+            trail.pop_back();
+            Row clear = ~(Row(1) << (e % ps));
+            T[e / ps] &= clear;
+            F[e / ps] &= clear;
+        }
+        qhead = mark;
+    }
+
+    // Unit propagation to fixpoint; false on conflict
+    bool propagate() {
+        while (qhead < trail.size()) {
+            int l = trail[qhead++];
+            if (!propagate_transitivity((l >> 1) / ps, (l >> 1) % ps, !(l & 1))) return false;
+
+            int false_lit = l ^ 1;
+            std::vector<int>& ws = watches[false_lit];
+            size_t keep = 0;
+            for (size_t w = 0; w < ws.size(); ++w) {
+                int c = ws[w];
+                int* lits = &clause_lits[clause_start[c]];
+                int size = static_cast<int>(clause_start[c + 1] - clause_start[c]);
+                if (lits[0] == false_lit) std::swap(lits[0], lits[1]);
+                if (lit_value(lits[0]) == TRUE) {
+                    ws[keep++] = c;
+                    continue;
+                }
+                bool moved = false;
+                for (int k = 2; k < size; ++k) {
+                    if (lit_value(lits[k]) != FALSE) {
+                        std::swap(lits[1], lits[k]);
+                        watches[lits[1]].push_back(c);
+                        moved = true;
+                        break;
+                    }
+                }
+                if (moved) continue;
+                ws[keep++] = c;
+                int first = lits[0];
+                if (lit_value(first) == FALSE) {
+                    conflict.assign(lits, lits + size);
+                    conflict_clause = c;
+                    for (++w; w < ws.size(); ++w) ws[keep++] = ws[w];
+                    ws.resize(keep);
+                    return false;
+                }
+                int e = first >> 1;
+                (first & 1 ? F : T)[e / ps] |= Row(1) << (e % ps);
+                level[e] = decision_level;
+                reason_clause[e] = c;
+                trail.push_back(first);
+            }
+            ws.resize(keep);
+        }
+        return true;
+    }
+
+private:
+    // Root assignments, clauses simplified against them, triangles
+    void build(const std::vector<CellSpan>& partitions) {
+        int full = ps - 1;
+        for (int i = 0; i < ps; ++i) {
+            for (int j = 0; j < ps; ++j) {
+                if (BitOps::is_subset(i, j)) assign(i, j, true);
+            }
+        }
+        assign(full, 0, false);
+
+        std::set<std::vector<int>> seen;
+        auto add_clause = [&](std::vector<int> lits) {
+            std::sort(lits.begin(), lits.end());
+            lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+            std::vector<int> kept;
+            for (size_t k = 0; k < lits.size(); ++k) {
+                if (k + 1 < lits.size() && (lits[k] ^ 1) == lits[k + 1]) return;   // Tautology
+                int v = lit_value(lits[k]);
+                if (v == TRUE) return;
+                if (v == OPEN) kept.push_back(lits[k]);
+            }
+            if (!seen.insert(kept).second) return;
+            if (kept.empty()) {
+                root_conflict = true;
+            } else if (kept.size() == 1) {
+                if (!assign((kept[0] >> 1) / ps, (kept[0] >> 1) % ps, !(kept[0] & 1))) root_conflict = true;
+            } else {
+                int c = static_cast<int>(clause_start.size());
+                clause_start.push_back(static_cast<uint32_t>(clause_lits.size()));
+                clause_lits.insert(clause_lits.end(), kept.begin(), kept.end());
+                watches[kept[0]].push_back(c);
+                watches[kept[1]].push_back(c);
+            }
+        };
+        auto R = [&](int i, int j) { return lit(i * ps + j, false); };
+        auto notR = [&](int i, int j) { return lit(i * ps + j, true); };
+
+        // CSTP and strict CSTP over disjoint (A, B), (C, D)
+        for (int A = 0; A < ps; ++A) {
+            for (int B = full & ~A; ; B = (B - 1) & (full & ~A)) {
+                for (int C = 0; C < ps; ++C) {
+                    for (int D = full & ~C; ; D = (D - 1) & (full & ~C)) {
+                        int AB = A | B, CD = C | D;
+                        add_clause({notR(A, C), notR(B, D), R(AB, CD)});
+                        add_clause({notR(A, C), R(C, A), notR(B, D), R(D, B), R(AB, CD)});
+                        add_clause({notR(A, C), R(C, A), notR(B, D), R(D, B), notR(CD, AB)});
+                        if (D == 0) break;
+                    }
+                }
+                if (B == 0) break;
+            }
+        }
+        common_clauses = clause_start.size();
+
+        // Not-Dilation
+        for (CellSpan partition : partitions) {
+            for (int E = 0; E < ps; ++E) {
+                for (int Fm = E; Fm < ps; ++Fm) {
+                    std::vector<int> some_cell;
+                    for (int C : partition) {
+                        some_cell.push_back(R(E & C, Fm & C));
+                        some_cell.push_back(R(Fm & C, E & C));
+                    }
+                    for (int premise : {notR(E, Fm), notR(Fm, E)}) {
+                        std::vector<int> lits = some_cell;
+                        lits.push_back(premise);
+                        add_clause(lits);
+                    }
+                }
+            }
+        }
+        clause_start.push_back(static_cast<uint32_t>(clause_lits.size()));
+
+        for (int i = 0; i < ps; ++i) {
+            for (int j = 0; j < ps; ++j) {
+                for (int k = 0; k < ps; ++k) {
+                    if (i == j || j == k || i == k) continue;
+                    int ij = i * ps + j, jk = j * ps + k, ik = i * ps + k;
+                    if (value(ij) == FALSE || value(jk) == FALSE || value(ik) == TRUE) continue;
+                    triangles.push_back({ij, jk, ik});
+                }
+            }
+        }
+    }
+
+    // Transitivity clauses through entry (i, j), read off the bit rows
+    bool propagate_transitivity(int i, int j, bool v) {
+        auto pos = [this](int a, int b) { return lit(a * ps + b, false); };
+        auto neg = [this](int a, int b) { return lit(a * ps + b, true); };
+        if (v) {
+            // R[i][j] ∧ R[j][k] → R[i][k]; R[i][j] ∧ ¬R[i][k] → ¬R[j][k]
+            if (Row clash = T[j] & F[i]) {
+                int k = __builtin_ctzll(clash);
+                conflict_clause = -1;
+                conflict = {neg(i, j), neg(j, k), pos(i, k)};
+                return false;
+            }
+            for (Row m = T[j] & ~T[i]; m; m &= m - 1) {
+                int k = __builtin_ctzll(m);
+                imply(i, k, true, pos(i, j), pos(j, k));
+            }
+            for (Row m = F[i] & ~F[j]; m; m &= m - 1) {
+                int k = __builtin_ctzll(m);
+                imply(j, k, false, pos(i, j), neg(i, k));
+            }
+            // R[k][i] ∧ R[i][j] → R[k][j]; ¬R[k][j] ∧ R[i][j] → ¬R[k][i]
+            for (int k = 0; k < ps; ++k) {
+                bool ki = (T[k] >> i) & 1, not_kj = (F[k] >> j) & 1;
+                if (ki && not_kj) {
+                    conflict_clause = -1;
+                    conflict = {neg(k, i), neg(i, j), pos(k, j)};
+                    return false;
+                }
+                if (ki && !imply(k, j, true, pos(k, i), pos(i, j))) return false;
+                if (not_kj && !imply(k, i, false, neg(k, j), pos(i, j))) return false;
+            }
+        } else {
+            // ¬R[i][j]: no k with R[i][k] ∧ R[k][j]
+            for (int k = 0; k < ps; ++k) {
+                bool ik = (T[i] >> k) & 1, kj = (T[k] >> j) & 1;
+                if (ik && kj) {
+                    conflict_clause = -1;
+                    conflict = {neg(i, k), neg(k, j), pos(i, j)};
+                    return false;
+                }
+                if (ik && !imply(k, j, false, pos(i, k), neg(i, j))) return false;
+                if (kj && !imply(i, k, false, pos(k, j), neg(i, j))) return false;
+            }
+        }
+        return true;
+    }
+};
+
+// ============================================================
+//  FrameCounter - Native #SAT-style count of a pair's frames
+// ============================================================
+//  DPLL counting on top of FramePropagator, with A2D as one lazily
+//  checked global constraint. At every node the open entries are
+//  split into components that share no unresolved constraint;
+//  components are counted apart, multiplied, and cached under
+//  their residual constraints. Without a pair it counts the
+//  frames of the common axioms alone.
+// ============================================================
+
+class FrameCounter : private FramePropagator {
+public:
+    struct Stats {
+        uint64_t nodes = 0;
+        uint64_t cache_hits = 0;
+        uint64_t splits = 0;        // Nodes whose open entries fell into several components
+        bool saturated = false;     // Count exceeded 2^64 - 1
+        bool timed_out = false;
+    };
+
+private:
+    enum A2DState { WITNESSED, PENDING, FAILED };
+
+    bool has_pair;
+    CellSpan I1, I2;
+    std::vector<int> ck;
+
+    // Per-node scratch for component analysis
+    std::vector<int> parent;
+    std::vector<int> degree;
+    std::vector<uint64_t> in_scope;   // Entry is in the open set iff in_scope[e] == scope
+    uint64_t scope = 0;
+
+    struct KeyHash {
+        size_t operator()(const std::vector<uint32_t>& key) const {
+            uint64_t h = 1469598103934665603ULL;
+            for (uint32_t w : key) h = (h ^ w) * 1099511628211ULL;
+            return static_cast<size_t>(h);
+        }
+    };
+    std::unordered_map<std::vector<uint32_t>, uint64_t, KeyHash> cache;
+    size_t cache_limit;
+    std::chrono::steady_clock::time_point deadline;
+    Stats counters;
+
+public:
+    FrameCounter(const PartitionTable& table, const Task& task, size_t max_cache_entries = 1 << 20)
+        : FramePropagator(table.universe_size(),
+                          {table.cells_of(task.partition1), table.cells_of(task.partition2)}),
+          has_pair(true), I1(table.cells_of(task.partition1)), I2(table.cells_of(task.partition2)),
+          ck(NativeFrame::common_knowledge(I1, I2, table.universe_size())),
+          parent(ps * ps), degree(ps * ps), in_scope(ps * ps, 0), cache_limit(max_cache_entries) {}
+
+    // Frames of the common axioms only
+    explicit FrameCounter(int universe_size, size_t max_cache_entries = 1 << 20)
+        : FramePropagator(universe_size, {}), has_pair(false),
+          parent(ps * ps), degree(ps * ps), in_scope(ps * ps, 0), cache_limit(max_cache_entries) {}
+
+    // Number of frames; 0 when there are none. Check stats() for
+    // saturation or timeout, where the value is meaningless.
+    uint64_t count(unsigned timeout_ms) {
+        deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        if (root_conflict || !propagate() || a2d_state() == FAILED) return 0;
+        std::vector<int> open;
+        for (int e = 0; e < ps * ps; ++e) {
+            if (value(e) == OPEN) open.push_back(e);
+        }
+        return count_open(open);
+    }
+
+    const Stats& stats() const { return counters; }
+
+private:
+    // Lazy A2D. Pairs (E, F) whose cells are all decided either witness
+    // A2D or drop out; an open pair also drops out once CK of its largest
+    // reachable A and B no longer meet (CK is monotone). With `open_pairs`,
+    // records (E*ps+F, known A, known B) of every pair still open.
+    A2DState a2d_state(std::vector<std::array<int, 3>>* open_pairs = nullptr) const {
+        if (!has_pair) return WITNESSED;
+        bool pending = false;
+        for (int E = 0; E < ps; ++E) {
+            for (int Fm = 0; Fm < ps; ++Fm) {
+                int A = 0, A_open = 0, B = 0, B_open = 0;
+                for (int C : I1) {
+                    int v = value((E & C) * ps + (Fm & C));
+                    if (v == TRUE) A |= C;
+                    else if (v == OPEN) A_open |= C;
+                }
+                for (int C : I2) {
+                    int v = value((E & C) * ps + (Fm & C));
+                    if (v == FALSE) B |= C;
+                    else if (v == OPEN) B_open |= C;
+                }
+                if (A_open == 0 && B_open == 0) {
+                    if (ck[A] & ck[B]) return WITNESSED;
+                    continue;
+                }
+                if ((ck[A | A_open] & ck[B | B_open]) == 0) continue;
+                pending = true;
+                if (open_pairs) open_pairs->push_back({E * ps + Fm, A, B});
+            }
+        }
+        return pending ? PENDING : FAILED;
+    }
+
+    int find(int e) {
+        while (parent[e] != e) e = parent[e] = parent[parent[e]];
+        return e;
+    }
+
+    void unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a != b) parent[a] = b;
+    }
+
+    static uint64_t saturating_add(uint64_t a, uint64_t b, bool& saturated) {
+        if (a > std::numeric_limits<uint64_t>::max() - b) {
+            saturated = true;
+            return std::numeric_limits<uint64_t>::max();
+        }
+        return a + b;
+    }
+
+    static uint64_t saturating_mul(uint64_t a, uint64_t b, bool& saturated) {
+        if (a != 0 && b > std::numeric_limits<uint64_t>::max() / a) {
+            saturated = true;
+            return std::numeric_limits<uint64_t>::max();
+        }
+        return a * b;
+    }
+
+    // Count completions of the open entries: split into components and
+    // multiply their counts. Entries in no unresolved constraint are free.
+    uint64_t count_open(const std::vector<int>& open) {
+        if (open.empty()) return 1;
+        if (++counters.nodes % 1024 == 0 && std::chrono::steady_clock::now() > deadline) {
+            counters.timed_out = true;
+        }
+        if (counters.timed_out) return 0;
+
+        ++scope;
+        for (int e : open) {
+            parent[e] = e;
+            degree[e] = 0;
+            in_scope[e] = scope;
+        }
+        // Unresolved constraints: (kind, id, first open entry); kind 0 = clause,
+        // 1 = triangle. Open entries outside scope belong to sibling components
+        // still waiting to be counted; their constraints are skipped.
+        std::vector<std::array<int, 3>> active;
+        int open_lits[64];
+        auto link = [&](int kind, int id, const int* entries, int count) {
+            if (in_scope[entries[0]] != scope) return;
+            for (int k = 0; k < count; ++k) {
+                ++degree[entries[k]];
+                if (k > 0) unite(entries[0], entries[k]);
+            }
+            active.push_back({kind, id, entries[0]});
+        };
+
+        int num_clauses = static_cast<int>(clause_start.size()) - 1;
+        for (int c = 0; c < num_clauses; ++c) {
+            int count = 0;
+            bool satisfied = false;
+            for (uint32_t k = clause_start[c]; k < clause_start[c + 1]; ++k) {
+                int v = lit_value(clause_lits[k]);
+                if (v == TRUE) { satisfied = true; break; }
+                if (v == OPEN && count < 64) open_lits[count++] = clause_lits[k] >> 1;
+            }
+            if (!satisfied && count > 0) link(0, c, open_lits, count);
+        }
+        for (size_t t = 0; t < triangles.size(); ++t) {
+            const auto& tri = triangles[t];
+            int ij = value(tri[0]), jk = value(tri[1]), ik = value(tri[2]);
+            if (ij == FALSE || jk == FALSE || ik == TRUE) continue;
+            int count = 0;
+            for (int k = 0; k < 3; ++k) {
+                if (value(tri[k]) == OPEN) open_lits[count++] = tri[k];
+            }
+            if (count > 0) link(1, static_cast<int>(t), open_lits, count);
+        }
+        std::vector<std::array<int, 3>> open_pairs;
+        int a2d_root = -1;
+        if (a2d_state(&open_pairs) == PENDING) {
+            int first = -1;
+            for (const auto& pair : open_pairs) {
+                int E = pair[0] / ps, Fm = pair[0] % ps;
+                for (CellSpan partition : {I1, I2}) {
+                    for (int C : partition) {
+                        int e = (E & C) * ps + (Fm & C);
+                        if (value(e) != OPEN || in_scope[e] != scope) continue;
+                        ++degree[e];
+                        if (first < 0) first = e;
+                        else unite(first, e);
+                    }
+                }
+            }
+            a2d_root = first;
+        }
+
+        // Group entries and constraints by component
+        std::map<int, std::vector<int>> comp_entries;
+        std::map<int, std::vector<uint32_t>> comp_constraints;
+        uint64_t free_entries = 0;
+        for (int e : open) {
+            if (degree[e] == 0) ++free_entries;
+            else comp_entries[find(e)].push_back(e);
+        }
+        for (const auto& a : active) {
+            comp_constraints[find(a[2])].push_back(static_cast<uint32_t>(a[0] << 31 | a[1]));
+        }
+        if (a2d_root >= 0) a2d_root = find(a2d_root);
+        if (comp_entries.size() > 1) ++counters.splits;
+
+        uint64_t total = 1;
+        for (uint64_t f = 0; f < free_entries; ++f) total = saturating_mul(total, 2, counters.saturated);
+        for (const auto& [root, entries] : comp_entries) {
+            std::vector<uint32_t> key(entries.begin(), entries.end());
+            key.push_back(UINT32_MAX);
+            const auto& cons = comp_constraints[root];
+            key.insert(key.end(), cons.begin(), cons.end());
+            if (root == a2d_root) {
+                key.push_back(UINT32_MAX);
+                for (const auto& pair : open_pairs) key.insert(key.end(), pair.begin(), pair.end());
+            }
+            uint64_t c = count_component(entries, std::move(key));
+            total = saturating_mul(total, c, counters.saturated);
+            if (total == 0) break;
+        }
+        return total;
+    }
+
+    uint64_t count_component(const std::vector<int>& entries, std::vector<uint32_t> key) {
+        auto hit = cache.find(key);
+        if (hit != cache.end()) {
+            ++counters.cache_hits;
+            return hit->second;
+        }
+
+        // Branch on the most constrained entry
+        int branch = entries[0];
+        for (int e : entries) {
+            if (degree[e] > degree[branch]) branch = e;
+        }
+
+        uint64_t total = 0;
+        for (bool v : {true, false}) {
+            size_t mark = trail.size();
+            if (assign(branch / ps, branch % ps, v) && propagate() && a2d_state() != FAILED) {
+                std::vector<int> rest;
+                for (int e : entries) {
+                    if (value(e) == OPEN) rest.push_back(e);
+                }
+                total = saturating_add(total, count_open(rest), counters.saturated);
+            }
+            undo(mark);
+            if (counters.timed_out) return 0;
+        }
+
+        if (cache.size() >= cache_limit) cache.clear();
+        cache.emplace(std::move(key), total);
+        return total;
+    }
+};
+
+
+// ============================================================
+//  CommonFrameSet - All frames of the common axioms, stored once
+// ============================================================
+//  Backtracking over the open entries in index order with
+//  FramePropagator's closure propagation; every complete
+//  assignment is a frame of the pair-independent axioms. Frames
+//  are kept flat, ps rows each, so the pair axioms can then be
+//  tested natively per pair. Feasible for small universes only:
+//  n=3 has 739 such frames, n=4 already 1,460,308,442.
+// ============================================================
+
+class CommonFrameSet : private FramePropagator {
+    std::vector<Row> rows;     // Frame k is rows[k*ps .. (k+1)*ps)
+    size_t budget = 0;
+    bool over_budget = false;
+
+public:
+    static constexpr int MAX_UNIVERSE = 3;   // n = 4 would blow any frame budget
+
+    explicit CommonFrameSet(int universe_size) : FramePropagator(universe_size, {}) {}
+
+    // Enumerate at most max_frames frames; false if there are more
+    bool enumerate(size_t max_frames) {
+        rows.clear();
+        budget = max_frames;
+        over_budget = false;
+        if (!root_conflict && propagate()) search(0);
+        return !over_budget;
+    }
+
+    size_t size() const { return rows.size() / ps; }
+    int powerset_size() const { return ps; }
+    const Row* frame(size_t k) const { return rows.data() + k * ps; }
+
+private:
+    void search(int from) {
+        while (from < ps * ps && value(from) != OPEN) ++from;
+        if (from == ps * ps) {
+            if (size() >= budget) {
+                over_budget = true;
+                return;
+            }
+            rows.insert(rows.end(), T.begin(), T.end());
+            return;
+        }
+        for (bool v : {true, false}) {
+            size_t mark = trail.size();
+            if (assign(from / ps, from % ps, v) && propagate()) search(from + 1);
+            undo(mark);
+            if (over_budget) return;
+        }
+    }
+};
+
+// ============================================================
+//  LemmaPool - Lock-free shared short clauses
+// ============================================================
+//  Append-only slots holding lemmas of up to three literals that
+//  follow from the common axioms alone, so they hold for every
+//  pair. Each slot packs its literals (plus one, 21 bits each)
+//  into one word: a writer claims a slot with one fetch_add and
+//  publishes with a release store; readers walk the slots in
+//  order and stop at the first one not yet published, resuming
+//  there next time.
+// ============================================================
+
+class LemmaPool {
+public:
+    static constexpr size_t CAPACITY = size_t(1) << 16;
+    static constexpr int MAX_LITS = 3;
+    using Lemma = std::array<int, MAX_LITS>;   // Unused trailing literals are -1
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> slots;   // 0 = not yet published
+    std::atomic<size_t> claimed{0};
+    std::atomic<size_t> units{0};
+
+public:
+    LemmaPool() : slots(new std::atomic<uint64_t>[CAPACITY]) {
+        for (size_t k = 0; k < CAPACITY; ++k) slots[k].store(0, std::memory_order_relaxed);
+    }
+
+    // False when the pool is full
+    bool publish(const Lemma& lemma) {
+        size_t k = claimed.fetch_add(1, std::memory_order_relaxed);
+        if (k >= CAPACITY) return false;
+        if (lemma[1] < 0) ++units;
+        uint64_t packed = 0;
+        for (int t = 0; t < MAX_LITS; ++t) packed |= uint64_t(lemma[t] + 1) << (21 * t);
+        slots[k].store(packed, std::memory_order_release);
+        return true;
+    }
+
+    // Call fn(lemma) for each published lemma from cursor on and
+    // advance cursor past them
+    template <class Fn>
+    void import(size_t& cursor, Fn&& fn) const {
+        size_t end = std::min(claimed.load(std::memory_order_acquire), CAPACITY);
+        for (; cursor < end; ++cursor) {
+            uint64_t packed = slots[cursor].load(std::memory_order_acquire);
+            if (packed == 0) break;
+            Lemma lemma;
+            for (int t = 0; t < MAX_LITS; ++t) {
+                lemma[t] = static_cast<int>((packed >> (21 * t)) & 0x1FFFFF) - 1;
+            }
+            fn(lemma);
+        }
+    }
+
+    size_t size() const { return std::min(claimed.load(), CAPACITY); }
+    size_t unit_count() const { return units.load(); }
+};
+
+// ============================================================
+//  NativeSolver - Native CDCL frame search, Z3-free backend
+// ============================================================
+//  Decides one pair on top of FramePropagator: bit-row transitivity
+//  and monotonicity, watched CSTP / strict CSTP / Not-Dilation, and
+//  A2D checked after every propagation (its conflict clause is the
+//  current values of all decided A2D entries). Conflicts are
+//  analysed to the first UIP; the learned clause is added to the
+//  watched database and the search backjumps to its assertion
+//  level. Activity-ordered decisions with saved phases and Luby
+//  restarts; an optional hint matrix seeds the initial phases.
+//  With a LemmaPool, learned clauses of up to three literals whose whole
+//  derivation used only common-axiom clauses, transitivity and
+//  common root facts are published, and every search imports the
+//  pool at its start and at each restart.
+//  Same solve(Task) -> TaskResult shape as TaskSolver.
+// ============================================================
+
+class NativeSolver {
+public:
+    explicit NativeSolver(const PartitionTable& pt, LemmaPool* pool = nullptr)
+        : table(pt), lemmas(pool) {}
+
+    TaskResult solve(const Task& task, unsigned timeout_ms,
+                     const std::vector<std::vector<bool>>* hint = nullptr) {
+        Search search(table, task, lemmas, published);
+        if (hint) search.seed_phases(*hint);
+        return search.run(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms));
+    }
+
+private:
+    const PartitionTable& table;
+    LemmaPool* lemmas;
+    std::set<LemmaPool::Lemma> published;      // This worker's lemmas already in the pool
+
+    class Search : private FramePropagator {
+        static constexpr int RESTART_UNIT = 100;        // Conflicts per Luby unit
+        static constexpr size_t KEEP_LEARNED = 20000;   // Learned clauses kept at a restart
+
+        Task task;
+        CellSpan I1, I2;
+        std::vector<int> ck;
+        size_t num_original;                  // Clauses before any learning
+        std::vector<size_t> trail_lim;        // Trail size at each decision
+        std::vector<double> activity;
+        double bump = 1.0;
+        std::vector<uint8_t> phase;           // Saved value per entry
+        std::vector<uint8_t> seen;
+
+        // Lemma sharing: a clause or root fact is pure if it follows
+        // from the common axioms alone
+        LemmaPool* lemmas;
+        std::set<LemmaPool::Lemma>& published;
+        size_t pool_cursor = 0;
+        std::vector<uint8_t> clause_pure;
+        std::vector<uint8_t> root_pure;
+        bool a2d_conflict_pending = false;
+        size_t root_checked = 0;              // Root trail prefix already given a purity
+
+    public:
+        Search(const PartitionTable& table, const Task& t, LemmaPool* pool,
+               std::set<LemmaPool::Lemma>& shared)
+            : FramePropagator(table.universe_size(),
+                              {table.cells_of(t.partition1), table.cells_of(t.partition2)}),
+              task(t), I1(table.cells_of(t.partition1)), I2(table.cells_of(t.partition2)),
+              ck(NativeFrame::common_knowledge(I1, I2, table.universe_size())),
+              num_original(clause_start.size() - 1),
+              activity(ps * ps, 0.0), phase(ps * ps, 0), seen(ps * ps, 0),
+              lemmas(pool), published(shared), root_pure(ps * ps, 0) {
+            for (size_t c = 0; c < num_original; ++c) clause_pure.push_back(c < common_clauses);
+            for (int e = 0; e < ps * ps; ++e) root_pure[e] = BitOps::is_subset(e / ps, e % ps);
+            root_pure[(ps - 1) * ps] = 1;   // Non-triviality
+        }
+
+        void seed_phases(const std::vector<std::vector<bool>>& matrix) {
+            for (int e = 0; e < ps * ps; ++e) phase[e] = matrix[e / ps][e % ps];
+        }
+
+        TaskResult run(std::chrono::steady_clock::time_point deadline) {
+            TaskResult result;
+            result.task = task;
+            if (root_conflict || !import_lemmas() || !propagate() || a2d_failed()) {
+                return result;   // UNSAT
+            }
+
+            uint64_t conflicts = 0, restart_at = RESTART_UNIT, restarts = 0;
+            while (true) {
+                bool ok = propagate();
+                if (ok && decision_level == 0) mark_root_purity();
+                if (ok && a2d_failed()) {
+                    a2d_conflict();
+                    ok = false;
+                }
+                if (!ok) {
+                    ++conflicts;
+                    if (!resolve_conflict()) return result;   // UNSAT
+                    if (conflicts >= restart_at) {
+                        // Root purity reads reason clauses, so settle it for
+                        // every root fact before reduce_learned renumbers them
+                        backtrack(0);
+                        mark_root_purity();
+                        if (!import_lemmas()) return result;   // UNSAT
+                        mark_root_purity();
+                        reduce_learned();
+                        restart_at = conflicts + RESTART_UNIT * luby(++restarts);
+                    }
+                    if ((conflicts & 255) == 0 && std::chrono::steady_clock::now() > deadline) {
+                        result.status = TaskStatus::TIMEOUT;
+                        return result;
+                    }
+                    continue;
+                }
+
+                int e = pick_branch();
+                if (e < 0) {
+                    // Everything assigned and A2D not failed: A2D is witnessed
+                    result.status = TaskStatus::SAT;
+                    result.matrix = NativeFrame::to_matrix(T.data(), ps);
+                    return result;
+                }
+                trail_lim.push_back(trail.size());
+                ++decision_level;
+                assign(e / ps, e % ps, phase[e]);
+            }
+        }
+
+    private:
+        static uint64_t luby(uint64_t i) {
+            // 1 1 2 1 1 2 4 1 1 2 ...
+            uint64_t size = 1, seq = 0;
+            while (size < i + 1) {
+                ++seq;
+                size = 2 * size + 1;
+            }
+            while (size - 1 != i) {
+                size = (size - 1) >> 1;
+                --seq;
+                i = i % size;
+            }
+            return uint64_t(1) << seq;
+        }
+
+        // A2D can no longer be witnessed (see FrameCounter::a2d_state)
+        bool a2d_failed() const {
+            for (int E = 0; E < ps; ++E) {
+                for (int Fm = 0; Fm < ps; ++Fm) {
+                    int A = 0, A_open = 0, B = 0, B_open = 0;
+                    for (int C : I1) {
+                        int v = value((E & C) * ps + (Fm & C));
+                        if (v == TRUE) A |= C;
+                        else if (v == OPEN) A_open |= C;
+                    }
+                    for (int C : I2) {
+                        int v = value((E & C) * ps + (Fm & C));
+                        if (v == FALSE) B |= C;
+                        else if (v == OPEN) B_open |= C;
+                    }
+                    if (ck[A | A_open] & ck[B | B_open]) return false;
+                }
+            }
+            return true;
+        }
+
+        // Conflict clause for a failed A2D. A pair (E, F) fails because
+        // its reachable A and B are too small: only I1 entries that are
+        // false and I2 entries that are true shrink them, so the clause
+        // negates exactly those.
+        void a2d_conflict() {
+            a2d_conflict_pending = true;
+            conflict.clear();
+            auto add = [this](int e, int shrinking) {
+                if (value(e) != shrinking || seen[e] || level[e] == 0) return;
+                seen[e] = 1;
+                conflict.push_back(lit(e, shrinking == TRUE));
+            };
+            for (int E = 0; E < ps; ++E) {
+                for (int Fm = 0; Fm < ps; ++Fm) {
+                    for (int C : I1) add((E & C) * ps + (Fm & C), FALSE);
+                    for (int C : I2) add((E & C) * ps + (Fm & C), TRUE);
+                }
+            }
+            for (int l : conflict) seen[l >> 1] = 0;
+        }
+
+        // Analyse `conflict`, learn, backjump and assert; false at level 0
+        bool resolve_conflict() {
+            bool pure = !a2d_conflict_pending && (conflict_clause < 0 || clause_pure[conflict_clause]);
+            a2d_conflict_pending = false;
+            int top = 0;
+            for (int l : conflict) top = std::max(top, level[l >> 1]);
+            if (top == 0) return false;
+            if (top < decision_level) backtrack(top);
+
+            std::vector<int> learnt(1, -1);
+            std::vector<int> reason = conflict;
+            int paths = 0;
+            int p = -1;
+            size_t index = trail.size();
+            while (true) {
+                for (int q : reason) {
+                    if (q == p) continue;
+                    int v = q >> 1;
+                    if (level[v] == 0) pure = pure && root_pure[v];
+                    if (seen[v] || level[v] == 0) continue;
+                    seen[v] = 1;
+                    bump_activity(v);
+                    if (level[v] >= decision_level) ++paths;
+                    else learnt.push_back(q);
+                }
+                while (!seen[trail[--index] >> 1]) {}
+                p = trail[index];
+                seen[p >> 1] = 0;
+                if (--paths == 0) break;
+                int e = p >> 1;
+                if (reason_clause[e] >= 0) pure = pure && clause_pure[reason_clause[e]];
+                reason = reason_of(p);
+            }
+            learnt[0] = p ^ 1;
+            for (size_t k = 1; k < learnt.size(); ++k) seen[learnt[k] >> 1] = 0;
+            bump *= 1.05;
+
+            // Assertion level: highest level among the rest, moved to slot 1
+            int back = 0;
+            for (size_t k = 1; k < learnt.size(); ++k) {
+                if (level[learnt[k] >> 1] > back) {
+                    back = level[learnt[k] >> 1];
+                    std::swap(learnt[1], learnt[k]);
+                }
+            }
+            backtrack(back);
+            if (pure && lemmas && learnt.size() <= LemmaPool::MAX_LITS) {
+                LemmaPool::Lemma lemma;
+                lemma.fill(-1);
+                std::copy(learnt.begin(), learnt.end(), lemma.begin());
+                std::sort(lemma.begin(), lemma.begin() + learnt.size());
+                if (published.insert(lemma).second) lemmas->publish(lemma);
+            }
+
+            int e = learnt[0] >> 1;
+            if (learnt.size() == 1) {
+                root_pure[e] = pure;
+                return assign(e / ps, e % ps, !(learnt[0] & 1));
+            }
+            int c = static_cast<int>(clause_start.size()) - 1;
+            clause_lits.insert(clause_lits.end(), learnt.begin(), learnt.end());
+            clause_start.push_back(static_cast<uint32_t>(clause_lits.size()));
+            clause_pure.push_back(pure);
+            watches[learnt[0]].push_back(c);
+            watches[learnt[1]].push_back(c);
+            (learnt[0] & 1 ? F : T)[e / ps] |= Row(1) << (e % ps);
+            level[e] = decision_level;
+            reason_clause[e] = c;
+            trail.push_back(learnt[0]);
+            return true;
+        }
+
+        // Literals of the clause that implied p (p itself included)
+        std::vector<int> reason_of(int p) const {
+            int e = p >> 1;
+            if (reason_clause[e] >= 0) {
+                int c = reason_clause[e];
+                return std::vector<int>(clause_lits.begin() + clause_start[c],
+                                        clause_lits.begin() + clause_start[c + 1]);
+            }
+            std::vector<int> reason{p};
+            for (int a : reason_ante[e]) {
+                if (a >= 0) reason.push_back(a ^ 1);
+            }
+            return reason;
+        }
+
+        void backtrack(int target) {
+            if (decision_level <= target) return;
+            size_t mark = trail_lim[target];
+            for (size_t k = mark; k < trail.size(); ++k) {
+                phase[trail[k] >> 1] = !(trail[k] & 1);
+            }
+            undo(mark);
+            trail_lim.resize(target);
+            decision_level = target;
+        }
+
+        // Root facts implied by pure clauses or transitivity from pure
+        // root facts are pure; the trail lists antecedents first
+        void mark_root_purity() {
+            for (; root_checked < trail.size(); ++root_checked) {
+                int e = trail[root_checked] >> 1;
+                if (root_pure[e]) continue;
+                bool pure = false;
+                if (reason_clause[e] >= 0) {
+                    int c = reason_clause[e];
+                    pure = clause_pure[c];
+                    for (uint32_t k = clause_start[c]; pure && k < clause_start[c + 1]; ++k) {
+                        if ((clause_lits[k] >> 1) != e) pure = root_pure[clause_lits[k] >> 1];
+                    }
+                } else if (reason_ante[e][0] >= 0) {
+                    pure = true;
+                    for (int a : reason_ante[e]) {
+                        if (a >= 0) pure = pure && root_pure[a >> 1];
+                    }
+                }
+                root_pure[e] = pure;
+            }
+        }
+
+        // At level 0: take in the pool's lemmas not seen yet, simplified
+        // against the root, as pure facts or watched clauses; false on
+        // a conflict
+        bool import_lemmas() {
+            if (!lemmas) return true;
+            bool ok = true;
+            lemmas->import(pool_cursor, [&](const LemmaPool::Lemma& lemma) {
+                if (!ok) return;
+                std::vector<int> open;
+                bool pure = true;   // Of a unit left after dropping root-false literals
+                for (int l : lemma) {
+                    if (l < 0) break;
+                    int v = lit_value(l);
+                    if (v == TRUE) return;
+                    if (v == OPEN) open.push_back(l);
+                    else pure = pure && root_pure[l >> 1];
+                }
+                if (open.empty()) {
+                    ok = false;
+                } else if (open.size() == 1) {
+                    int e = open[0] >> 1;
+                    root_pure[e] = pure;
+                    ok = assign(e / ps, e % ps, !(open[0] & 1)) && propagate();
+                } else {
+                    int c = static_cast<int>(clause_start.size()) - 1;
+                    clause_lits.insert(clause_lits.end(), open.begin(), open.end());
+                    clause_start.push_back(static_cast<uint32_t>(clause_lits.size()));
+                    clause_pure.push_back(pure);
+                    watches[open[0]].push_back(c);
+                    watches[open[1]].push_back(c);
+                }
+            });
+            return ok;
+        }
+
+        void bump_activity(int e) {
+            if ((activity[e] += bump) > 1e100) {
+                for (double& a : activity) a *= 1e-100;
+                bump *= 1e-100;
+            }
+        }
+
+        int pick_branch() const {
+            int best = -1;
+            for (int e = 0; e < ps * ps; ++e) {
+                if (value(e) == OPEN && (best < 0 || activity[e] > activity[best])) best = e;
+            }
+            return best;
+        }
+
+        // At level 0: keep short learned clauses and the newest ones,
+        // renumber the root facts' reasons, then rebuild every watch list
+        void reduce_learned() {
+            size_t total = clause_start.size() - 1;
+            if (total - num_original <= KEEP_LEARNED) return;
+            std::vector<int> lits(clause_lits.begin(), clause_lits.begin() + clause_start[num_original]);
+            std::vector<uint32_t> starts(clause_start.begin(), clause_start.begin() + num_original + 1);
+            std::vector<uint8_t> pure(clause_pure.begin(), clause_pure.begin() + num_original);
+            std::vector<int> renumbered(total, -1);   // Learned clause -> new index, -1 dropped
+            for (size_t c = num_original; c < total; ++c) {
+                uint32_t size = clause_start[c + 1] - clause_start[c];
+                if (size > 8 && total - c > KEEP_LEARNED / 2) continue;
+                renumbered[c] = static_cast<int>(starts.size()) - 1;
+                lits.insert(lits.end(), clause_lits.begin() + clause_start[c],
+                            clause_lits.begin() + clause_start[c + 1]);
+                starts.push_back(static_cast<uint32_t>(lits.size()));
+                pure.push_back(clause_pure[c]);
+            }
+            clause_lits.swap(lits);
+            clause_start.swap(starts);
+            clause_pure.swap(pure);
+            // Root facts keep their purity (see mark_root_purity); a fact
+            // whose reason was dropped is left without one, which conflict
+            // analysis never asks for at level 0
+            for (int p : trail) {
+                int& c = reason_clause[p >> 1];
+                if (c >= static_cast<int>(num_original)) c = renumbered[c];
+            }
+            for (auto& ws : watches) ws.clear();
+            for (size_t c = 0; c + 1 < clause_start.size(); ++c) {
+                int* first = &clause_lits[clause_start[c]];
+                int size = static_cast<int>(clause_start[c + 1] - clause_start[c]);
+                // Non-false literals first, so the watches are valid at level 0
+                for (int slot = 0; slot < 2; ++slot) {
+                    for (int k = slot; k < size; ++k) {
+                        if (lit_value(first[k]) != FALSE) {
+                            std::swap(first[slot], first[k]);
+                            break;
+                        }
+                    }
+                }
+                watches[first[0]].push_back(static_cast<int>(c));
+                watches[first[1]].push_back(static_cast<int>(c));
+            }
+        }
+    };
+};
+
+// ============================================================
+//  SolverConfig - Per-worker solving options
+// ============================================================
+
+enum class MinimizeMode {
+    NONE,       // Any model per SAT task
+    OPTIMIZE,   // z3::optimize: fewest extension entries per task
+    TOTALIZER   // Same objective via incremental totalizer bounds
+};
+
+enum class SolverEngine {
+    Z3,         // TaskSolver's Z3 encoding
+    NATIVE      // NativeSolver: CDCL over bit rows
+};
+
+struct SolverConfig {
+    SolverEngine engine = SolverEngine::Z3;
+    bool cross_check = false;  // Decide every task with both engines and compare
+    unsigned z3_threads = 1;   // Z3 internal threads per task (1 = sequential)
+    MinimizeMode minimize = MinimizeMode::NONE;
+    IncumbentBound* incumbent = nullptr;   // Shared across workers when minimizing
+    ModelStream* models = nullptr;         // Non-null: enumerate all frames of SAT tasks
+    uint64_t model_limit = 0;              // Per-task cap on enumerated frames (0 = none)
+    bool modulo_symmetry = false;          // One frame per orbit of the pair's automorphisms
+    bool model_reuse = false;              // Try collected frames natively before solving
+    bool phase_hints = false;              // Seed each check with a related earlier model
+    const std::vector<int8_t>* backbone = nullptr;  // Non-null: fold these entries (see Backbone)
+    bool core_pruning = false;             // Guard axiom groups and share UNSAT cores
+    CoreFacts* core_facts = nullptr;       // Shared across workers when core pruning
+    bool share_lemmas = false;             // Native engine: pool common-axiom lemmas
+    LemmaPool* lemmas = nullptr;           // Shared across workers when sharing lemmas
+    int recycle_every = 0;                 // Rebuild the Z3 context after this many tasks (0 = never)
+    size_t recycle_above_mb = 0;           // ... or once Z3's allocation estimate exceeds this
+    bool lazy_axioms = false;              // Add transitivity/CSTP only as models violate them
+    size_t task_budget_mb = 0;             // Tasks estimated above this are MEMOUT unsolved (0 = off)
+    A2DEncoding a2d_encoding = A2DEncoding::EXPANDED;
+    Totality totality = Totality::OFF;     // Require a total preorder (Z3 engine only)
+    RelationEncoding relation = RelationEncoding::MATRIX;
+};
+
+// ============================================================
+//  TaskSolver - Encodes and solves single tasks in one context
+// ============================================================
+//  Owns a Z3 context with its variables and encoder; shared by
+//  worker threads and worker processes. Not thread-safe: one
+//  TaskSolver per worker.
+// ============================================================
+
+class TaskSolver {
+    const PartitionTable& table;
+    SolverConfig config;
+    NativeSolver native;
+
+    // Z3 context with the variables and encoder built over it; replaced
+    // wholesale when the recycling policy fires (see maybe_recycle)
+    struct Z3State {
+        z3::context ctx;
+        FrameVariables vars;
+        AxiomEncoder encoder;
+
+        Z3State(int universe_size, const SolverConfig& config)
+            : ctx(), vars(ctx, universe_size, /*silent=*/true, config.relation),
+              encoder(vars, /*silent=*/true) {
+            if (config.backbone) vars.fix(*config.backbone);
+            encoder.set_a2d_encoding(config.a2d_encoding);
+            encoder.set_totality(config.totality);
+        }
+    };
+    std::unique_ptr<Z3State> state;
+    int tasks_on_context = 0;
+    std::chrono::steady_clock::time_point context_born = std::chrono::steady_clock::now();
+    long long last_rebuild_us = 0;
+
+    // A memory-triggered rebuild waits until the context has lived at
+    // least this many times the last rebuild cost
+    static constexpr int REBUILD_AMORTIZATION = 20;
+
+    // Universes from this size on always encode transitivity and CSTP
+    // lazily (n = 7: 2.1M transitivity and 14M CSTP clauses eagerly);
+    // at most LAZY_BATCH violated clauses are added per round
+    static constexpr int LAZY_UNIVERSE = 7;
+    static constexpr int LAZY_BATCH = 50000;
+
+    // Peak Z3 memory through the first check, per encoded literal and
+    // per R entry (measured on n = 7 orbit representatives)
+    static constexpr size_t BYTES_PER_LITERAL = 80;
+    static constexpr size_t BYTES_PER_ENTRY = 2048;
+
+public:
+    // 1 hour timeout per task - drop and move on if exceeded
+    static constexpr unsigned int SOLVER_TIMEOUT_MS = 3600000;
+
+    // Process-wide totals of --cross-check runs
+    struct CrossCheckStats {
+        std::atomic<int> tasks{0};
+        std::atomic<int> mismatches{0};
+        std::atomic<long long> z3_us{0};
+        std::atomic<long long> native_us{0};
+    };
+    static CrossCheckStats& cross_check_stats() {
+        static CrossCheckStats stats;
+        return stats;
+    }
+    
+    // Process-wide time spent on tasks that came out SAT
+    struct SatTimeStats {
+        std::atomic<int> tasks{0};
+        std::atomic<int> hinted{0};
+        std::atomic<long long> us{0};
+    };
+    static SatTimeStats& sat_time_stats() {
+        static SatTimeStats stats;
+        return stats;
+    }
+    
+    // Process-wide context rebuilds and their cost
+    struct RecycleStats {
+        std::atomic<int> recycles{0};
+        std::atomic<long long> rebuild_us{0};
+    };
+    static RecycleStats& recycle_stats() {
+        static RecycleStats stats;
+        return stats;
+    }
+    
+    // Process-wide tasks left MEMOUT by the per-task memory budget
+    static std::atomic<int>& over_budget_count() {
+        static std::atomic<int> count{0};
+        return count;
+    }
+    
+    // Process-wide rounds and clauses of lazily encoded axioms
+    struct LazyStats {
+        std::atomic<long long> rounds{0};
+        std::atomic<long long> clauses{0};
+    };
+    static LazyStats& lazy_stats() {
+        static LazyStats stats;
+        return stats;
+    }
+
+    explicit TaskSolver(const PartitionTable& pt, const SolverConfig& cfg = SolverConfig())
+        : table(pt), config(cfg), native(pt, cfg.lemmas),
+          state(new Z3State(pt.universe_size(), cfg)) {
+        // Past the native engine's 64-bit rows only Z3 can decide tasks,
+        // and only with witness A2D: expanded, the largest |T| run to
+        // hundreds of millions of literals
+        if (pt.universe_size() > NativeFrame::MAX_UNIVERSE) {
+            config.engine = SolverEngine::Z3;
+            config.cross_check = false;
+            config.a2d_encoding = A2DEncoding::WITNESS;
+            state->encoder.set_a2d_encoding(config.a2d_encoding);
+        }
+    }
+
+    // Estimated peak memory of deciding task on Z3: Not-Dilation for
+    // both partitions, A2D (ps^2 * |T| conjunctions expanded; |T| plus
+    // the cell selectors with witnesses) and, unless the common axioms
+    // are lazy, transitivity and both CSTPs
+    static size_t estimate_mb(const PartitionTable& table, const Task& task, bool lazy,
+                              A2DEncoding a2d) {
+        int n = table.universe_size();
+        double ps = 1 << n;
+        CellSpan I1 = table.cells_of(task.partition1);
+        CellSpan I2 = table.cells_of(task.partition2);
+        std::vector<int> ck = NativeFrame::common_knowledge(I1, I2, n);
+        double patterns = 0;   // |T|
+        for (int A : BitOps::generate_field(I1, n)) {
+            for (int B : BitOps::generate_field(I2, n)) patterns += (ck[A] & ck[B]) != 0;
+        }
+        double cells = static_cast<double>(I1.size() + I2.size());
+        double literals = ps * ps * (2 * cells + 2);
+        if (a2d == A2DEncoding::WITNESS) {
+            literals += patterns * cells;
+            for (CellSpan partition : {I1, I2}) {
+                for (int C : partition) {
+                    int size = SetTables::POPCOUNT[C];
+                    literals += 2.0 * (1 << (2 * size)) * (2 * size + 2);
+                }
+            }
+        } else {
+            literals += ps * ps * patterns * cells;
+        }
+        if (!lazy) {
+            double disjoint = std::pow(3.0, n);
+            literals += 3 * ps * ps * ps + 13 * disjoint * disjoint;
+        }
+        return static_cast<size_t>((literals * BYTES_PER_LITERAL + ps * ps * BYTES_PER_ENTRY) / (1 << 20));
+    }
+
+    bool lazy_axioms() const {
+        return (config.lazy_axioms || table.universe_size() >= LAZY_UNIVERSE) && !config.core_facts;
+    }
+
+    TaskResult solve(const Task& task) {
+        if (config.task_budget_mb > 0 && config.engine == SolverEngine::Z3 &&
+            estimate_mb(table, task, lazy_axioms() && config.minimize == MinimizeMode::NONE &&
+                                     !config.models, config.a2d_encoding) > config.task_budget_mb) {
+            ++over_budget_count();
+            TaskResult result;
+            result.task = task;
+            result.status = TaskStatus::MEMOUT;
+            return result;
+        }
+        maybe_recycle();
+        if (config.minimize == MinimizeMode::OPTIMIZE) return solve_optimize(task);
+        if (config.minimize == MinimizeMode::TOTALIZER) return solve_totalizer(task);
+        if (config.models) return solve_enumerate(task);
+        if (config.cross_check) return solve_cross_checked(task);
+        
+        auto start = std::chrono::steady_clock::now();
+        const std::vector<std::vector<bool>>* hint = config.phase_hints ? phase_hint(task) : nullptr;
+        TaskResult result = config.engine == SolverEngine::NATIVE
+                                ? native.solve(task, SOLVER_TIMEOUT_MS, hint)
+                                : solve_z3(task, hint);
+        if (result.status == TaskStatus::SAT) {
+            SatTimeStats& stats = sat_time_stats();
+            ++stats.tasks;
+            // Z3 takes the hint only through set_initial_value, and not when solving lazily
+            bool applied = config.engine == SolverEngine::NATIVE ||
+                           (HAVE_Z3_INITIAL_VALUE && !lazy_axioms());
+            if (hint && applied) ++stats.hinted;
+            stats.us += std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            if (config.phase_hints) {
+                last_model = result.matrix;
+                hint_by_partition[task.partition1] = result.matrix;
+            }
+        }
+        return result;
+    }
+
+    // Calibration probe (see AutoTuner): encode task as solve() would
+    // under this configuration and decide it, capped at timeout_ms.
+    // The native engine has no separate encoding step.
+    struct Probe {
+        double encode_ms = 0;
+        double solve_ms = 0;
+        bool finished = false;
+    };
+    Probe probe(const Task& task, unsigned timeout_ms) {
+        Probe r;
+        auto t0 = std::chrono::steady_clock::now();
+        auto deadline = t0 + std::chrono::milliseconds(timeout_ms);
+        auto since = [](std::chrono::steady_clock::time_point t) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t).count();
+        };
+        if (config.engine == SolverEngine::NATIVE && !config.cross_check) {
+            r.finished = native.solve(task, timeout_ms).status != TaskStatus::TIMEOUT;
+            r.solve_ms = since(t0);
+            return r;
+        }
+        if (lazy_axioms()) {
+            z3::solver solver(state->ctx, "QF_FD");
+            set_internal_threads(solver);
+            encode_lazy(solver, task);
+            r.encode_ms = since(t0);
+            auto t1 = std::chrono::steady_clock::now();
+            LazyStats discarded;
+            r.finished = check_lazy(solver, task, deadline, discarded).status != TaskStatus::TIMEOUT;
+            r.solve_ms = since(t1);
+        } else {
+            z3::solver solver(state->ctx);
+            set_internal_threads(solver);
+            encode_task(solver, task);
+            r.encode_ms = since(t0);
+            auto t1 = std::chrono::steady_clock::now();
+            z3::params p(state->ctx);
+            p.set("timeout", timeout_ms);
+            solver.set(p);
+            r.finished = solver.check() != z3::unknown;
+            r.solve_ms = since(t1);
+        }
+        return r;
+    }
+
+private:
+    // Between tasks: drop the context (and every AST it accumulated)
+    // after recycle_every tasks, or when Z3's allocation estimate is
+    // above recycle_above_mb and the context has amortized its build
+    void maybe_recycle() {
+        ++tasks_on_context;
+        auto now = std::chrono::steady_clock::now();
+        bool due = config.recycle_every > 0 && tasks_on_context > config.recycle_every;
+        if (!due && config.recycle_above_mb > 0 &&
+            Z3_get_estimated_alloc_size() > config.recycle_above_mb * 1024 * 1024) {
+            long long lived_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                now - context_born).count();
+            due = lived_us >= REBUILD_AMORTIZATION * last_rebuild_us;
+        }
+        if (!due) return;
+        state.reset();
+        state.reset(new Z3State(table.universe_size(), config));
+        context_born = std::chrono::steady_clock::now();
+        last_rebuild_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            context_born - now).count();
+        tasks_on_context = 1;
+        RecycleStats& stats = recycle_stats();
+        ++stats.recycles;
+        stats.rebuild_us += last_rebuild_us;
+    }
+
+    // Phase hints: this worker's latest model per I1, and its latest overall
+    std::unordered_map<int, std::vector<std::vector<bool>>> hint_by_partition;
+    std::vector<std::vector<bool>> last_model;
+
+    // Best related earlier model: same I1 first, else the latest one
+    const std::vector<std::vector<bool>>* phase_hint(const Task& task) const {
+        auto it = hint_by_partition.find(task.partition1);
+        if (it != hint_by_partition.end()) return &it->second;
+        return last_model.empty() ? nullptr : &last_model;
+    }
+
+    TaskResult solve_z3(const Task& task, const std::vector<std::vector<bool>>* hint = nullptr) {
+        if (lazy_axioms()) return solve_lazy(task);
+        TaskResult result;
+        result.task = task;
+
+        // Create fresh solver for this task
+        z3::solver solver(state->ctx);
+        z3::params p(state->ctx);
+        p.set("timeout", SOLVER_TIMEOUT_MS);
+        solver.set(p);
+        set_internal_threads(solver);
+        z3::expr_vector groups(state->ctx);
+        if (config.core_facts) {
+            groups = encode_task_guarded(solver, task);
+        } else {
+            encode_task(solver, task);
+        }
+#if HAVE_Z3_INITIAL_VALUE
+        if (hint) {
+            int ps = 1 << table.universe_size();
+            for (int i = 0; i < ps; ++i) {
+                for (int j = 0; j < ps; ++j) {
+                    if (state->vars.fixed(i, j) >= 0) continue;
+                    solver.set_initial_value(state->vars.get_R(i, j), static_cast<bool>((*hint)[i][j]));
+                }
+            }
+        }
+#else
+        (void)hint;
+#endif
+
+        // Solve (single attempt with long timeout)
+        z3::check_result r = config.core_facts ? solver.check(groups) : solver.check();
+
+        if (r == z3::sat) {
+            result.status = TaskStatus::SAT;
+            result.matrix = extract_matrix(solver.get_model());
+        } else if (r == z3::unknown) {
+            result.status = TaskStatus::TIMEOUT;
+        } else if (config.core_facts) {
+            record_core(solver, task, groups);
+        }
+        return result;
+    }
+
+    // Transitivity, CSTP and strict CSTP as cuts: check without them,
+    // add the clauses the model violates and re-check the same solver.
+    // UNSAT without them is UNSAT; a model violating none is a frame.
+    TaskResult solve_lazy(const Task& task) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SOLVER_TIMEOUT_MS);
+        z3::solver solver(state->ctx, "QF_FD");
+        set_internal_threads(solver);
+        encode_lazy(solver, task);
+        return check_lazy(solver, task, deadline, lazy_stats());
+    }
+
+    // Everything solve_lazy asserts before its first check
+    void encode_lazy(z3::solver& solver, const Task& task) {
+        CellSpan I1 = table.cells_of(task.partition1);
+        CellSpan I2 = table.cells_of(task.partition2);
+        state->encoder.encode_totality(solver);
+        if (state->vars.has_rows()) {
+            state->encoder.encode_transitivity(solver);   // Only ps^2 row constraints
+        }
+        state->encoder.encode_monotonicity(solver);
+        state->encoder.encode_non_triviality(solver);
+        state->encoder.encode_not_dilation(solver, I1);
+        state->encoder.encode_not_dilation(solver, I2);
+        state->encoder.encode_A2D(solver, I1, I2);
+    }
+
+    // solve_lazy's check-and-cut loop on an encode_lazy solver
+    TaskResult check_lazy(z3::solver& solver, const Task& task,
+                          std::chrono::steady_clock::time_point deadline, LazyStats& stats) {
+        TaskResult result;
+        result.task = task;
+        while (true) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0) {
+                result.status = TaskStatus::TIMEOUT;
+                return result;
+            }
+            z3::params p(state->ctx);
+            p.set("timeout", static_cast<unsigned>(left));
+            solver.set(p);
+            z3::check_result r = solver.check();
+            ++stats.rounds;
+            if (r != z3::sat) {
+                result.status = r == z3::unsat ? TaskStatus::UNSAT : TaskStatus::TIMEOUT;
+                return result;
+            }
+            std::vector<std::vector<bool>> matrix = extract_matrix(solver.get_model());
+            std::vector<WideFrame::Row> rows = WideFrame::from_matrix(matrix);
+            int added = state->encoder.encode_violated_common_axioms(solver, rows.data(), LAZY_BATCH);
+            stats.clauses += added;
+            if (added == 0) {
+                result.status = TaskStatus::SAT;
+                result.matrix = std::move(matrix);
+                return result;
+            }
+        }
+    }
+
+    // encode_task with Not-Dilation(I1), Not-Dilation(I2) and A2D each
+    // behind its own assumption literal, returned in that order
+    z3::expr_vector encode_task_guarded(z3::solver& solver, const Task& task) {
+        state->encoder.encode_common_axioms(solver);
+        CellSpan I1 = table.cells_of(task.partition1);
+        CellSpan I2 = table.cells_of(task.partition2);
+        z3::expr_vector groups(state->ctx);
+        auto guard = [&](const char* name, const std::function<void(z3::solver&)>& encode) {
+            z3::solver scratch(state->ctx);
+            encode(scratch);
+            z3::expr g = state->ctx.bool_const(name);
+            z3::expr_vector assertions = scratch.assertions();
+            for (unsigned k = 0; k < assertions.size(); ++k) {
+                solver.add(z3::implies(g, assertions[k]));
+            }
+            groups.push_back(g);
+        };
+        guard("group_nd1", [&](z3::solver& s) { state->encoder.encode_not_dilation(s, I1); });
+        guard("group_nd2", [&](z3::solver& s) { state->encoder.encode_not_dilation(s, I2); });
+        guard("group_a2d", [&](z3::solver& s) { state->encoder.encode_A2D(s, I1, I2); });
+        return groups;
+    }
+
+    // After an UNSAT check under groups: a core without A2D blames
+    // Not-Dilation. Each partition not yet classified is re-checked
+    // alone; if neither is infeasible on its own, the pair is.
+    void record_core(z3::solver& solver, const Task& task, const z3::expr_vector& groups) {
+        z3::expr_vector core = solver.unsat_core();
+        for (unsigned k = 0; k < core.size(); ++k) {
+            if (z3::eq(core[k], groups[2])) return;
+        }
+        CoreFacts& facts = *config.core_facts;
+        bool explained = false;
+        for (int k = 0; k < 2; ++k) {
+            int p = k == 0 ? task.partition1 : task.partition2;
+            if (facts.state(p) == CoreFacts::UNKNOWN) {
+                z3::expr_vector alone(state->ctx);
+                alone.push_back(groups[k]);
+                z3::check_result r = solver.check(alone);
+                if (r != z3::unknown) {
+                    facts.set_state(p, r == z3::unsat ? CoreFacts::INFEASIBLE : CoreFacts::FEASIBLE);
+                }
+            }
+            explained |= facts.state(p) == CoreFacts::INFEASIBLE;
+        }
+        if (!explained) facts.add_infeasible_pair(task.partition1, task.partition2);
+    }
+
+    // Both engines on the same task: decided statuses must agree and
+    // every SAT witness must pass the native axiom checks. Disagreements
+    // go to stderr; the configured engine's result is returned.
+    TaskResult solve_cross_checked(const Task& task) {
+        auto timed = [](auto&& run, std::atomic<long long>& total_us) {
+            auto start = std::chrono::steady_clock::now();
+            TaskResult r = run();
+            total_us += std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            return r;
+        };
+        CrossCheckStats& stats = cross_check_stats();
+        TaskResult z3_result = timed([&] { return solve_z3(task); }, stats.z3_us);
+        TaskResult native_result = timed([&] { return native.solve(task, SOLVER_TIMEOUT_MS); },
+                                         stats.native_us);
+        ++stats.tasks;
+
+        auto decided = [](TaskStatus st) { return st == TaskStatus::SAT || st == TaskStatus::UNSAT; };
+        std::string problem;
+        if (decided(z3_result.status) && decided(native_result.status) &&
+            z3_result.status != native_result.status) {
+            problem = std::string("Z3 ") + status_name(z3_result.status) +
+                      ", native " + status_name(native_result.status);
+        }
+        for (const TaskResult* r : {&z3_result, &native_result}) {
+            if (r->status == TaskStatus::SAT && !witness_valid(task, r->matrix)) {
+                problem += std::string(problem.empty() ? "" : "; ") +
+                           (r == &z3_result ? "Z3" : "native") + " witness fails the axioms";
+            }
+        }
+        if (!problem.empty()) {
+            ++stats.mismatches;
+            std::cerr << "Cross-check mismatch on task " << task.id << ": " << problem << "\n";
+        }
+        return config.engine == SolverEngine::NATIVE ? native_result : z3_result;
+    }
+
+    // Cross-checking needs the native engine, so n <= 6 and kernels exist
+    bool witness_valid(const Task& task, const std::vector<std::vector<bool>>& matrix) const {
+        std::vector<NativeFrame::Row> rows = NativeFrame::from_matrix(matrix);
+        FrameKernels kernels = FrameKernels::for_universe(table.universe_size());
+        CellSpan I1 = table.cells_of(task.partition1);
+        CellSpan I2 = table.cells_of(task.partition2);
+        return kernels.common_axioms(rows.data()) &&
+               kernels.not_dilation(rows.data(), I1) &&
+               kernels.not_dilation(rows.data(), I2) &&
+               kernels.agreeing_to_disagree(rows.data(), I1, I2,
+                   NativeFrame::common_knowledge(I1, I2, table.universe_size()));
+    }
+
+    void encode_task(z3::solver& solver, const Task& task) {
+        // Encode common axioms
+        state->encoder.encode_common_axioms(solver);
+
+        // Encode partition-specific axioms
+        CellSpan I1 = table.cells_of(task.partition1);
+        CellSpan I2 = table.cells_of(task.partition2);
+        state->encoder.encode_not_dilation(solver, I1);
+        state->encoder.encode_not_dilation(solver, I2);
+        state->encoder.encode_A2D(solver, I1, I2);
+    }
+
+    // Extension entries: R[i][j] with i not a subset of j (not forced by monotonicity)
+    z3::expr_vector extension_literals() {
+        z3::expr_vector lits(state->ctx);
+        for (int i = 0; i < state->vars.size(); ++i) {
+            for (int j = 0; j < state->vars.size(); ++j) {
+                if (!BitOps::is_subset(i, j)) lits.push_back(state->vars.get_R(i, j));
+            }
+        }
+        return lits;
+    }
+
+    // Branch-and-bound step: minimize the extension count of this task
+    // subject to beating the shared incumbent (if any). UNSAT under that
+    // bound means the pair cannot improve on the incumbent: PRUNED.
+    TaskResult solve_optimize(const Task& task) {
+        TaskResult result;
+        result.task = task;
+
+        z3::solver encoded(state->ctx);
+        encode_task(encoded, task);
+
+        z3::optimize opt(state->ctx);
+        z3::params p(state->ctx);
+        p.set("timeout", SOLVER_TIMEOUT_MS);
+        opt.set(p);
+        z3::expr_vector assertions = encoded.assertions();
+        for (unsigned k = 0; k < assertions.size(); ++k) opt.add(assertions[k]);
+
+        z3::expr_vector ext = extension_literals();
+        int bound = config.incumbent ? config.incumbent->get() : IncumbentBound::NONE;
+        if (bound != IncumbentBound::NONE) {
+            if (bound == 0) {
+                result.status = TaskStatus::PRUNED;
+                return result;
+            }
+            opt.add(z3::atmost(ext, static_cast<unsigned>(bound - 1)));
+        }
+        for (unsigned k = 0; k < ext.size(); ++k) opt.add_soft(!ext[k], 1);
+
+        z3::check_result r = opt.check();
+        if (r == z3::sat) {
+            result.status = TaskStatus::SAT;
+            result.matrix = extract_matrix(opt.get_model());
+            if (config.incumbent) config.incumbent->offer(count_extensions(result.matrix));
+        } else if (r == z3::unsat) {
+            result.status = bound == IncumbentBound::NONE ? TaskStatus::UNSAT : TaskStatus::PRUNED;
+        } else {
+            result.status = TaskStatus::TIMEOUT;
+        }
+        return result;
+    }
+
+    // Branch-and-bound step with a native loop: after each model, assume
+    // "extension count < current count" through a totalizer built once per
+    // task and re-check the same solver until UNSAT. The last model is then
+    // provably minimal for the pair (below the incumbent at task start).
+    TaskResult solve_totalizer(const Task& task) {
+        TaskResult result;
+        result.task = task;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SOLVER_TIMEOUT_MS);
+
+        // QF_FD selects the incremental SAT back end, which keeps learned
+        // clauses across the assumption checks below
+        z3::solver solver(state->ctx, "QF_FD");
+        set_internal_threads(solver);
+        encode_task(solver, task);
+        z3::expr_vector ext = extension_literals();
+
+        auto check = [&](const z3::expr_vector& assumptions) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0) return z3::unknown;
+            z3::params p(state->ctx);
+            p.set("timeout", static_cast<unsigned>(left));
+            solver.set(p);
+            return solver.check(assumptions);
+        };
+
+        int bound = config.incumbent ? config.incumbent->get() : IncumbentBound::NONE;
+        if (bound == 0) {
+            result.status = TaskStatus::PRUNED;
+            return result;
+        }
+
+        // First model: below the incumbent if there is one
+        std::unique_ptr<Totalizer> counter;
+        z3::expr_vector assumptions(state->ctx);
+        if (bound != IncumbentBound::NONE) {
+            counter.reset(new Totalizer(solver, ext, static_cast<unsigned>(bound), "tot"));
+            assumptions.push_back(counter->less_than(static_cast<unsigned>(bound)));
+        }
+        z3::check_result r = check(assumptions);
+        if (r == z3::unsat) {
+            result.status = bound == IncumbentBound::NONE ? TaskStatus::UNSAT : TaskStatus::PRUNED;
+            return result;
+        }
+        if (r == z3::unknown) {
+            result.status = TaskStatus::TIMEOUT;
+            return result;
+        }
+        result.status = TaskStatus::SAT;
+        result.matrix = extract_matrix(solver.get_model());
+        int count = count_extensions(result.matrix);
+
+        // Tighten until UNSAT (optimal) or out of time (best found so far)
+        if (!counter && count > 0) {
+            counter.reset(new Totalizer(solver, ext, static_cast<unsigned>(count), "tot"));
+        }
+        while (count > 0) {
+            z3::expr_vector tighter(state->ctx);
+            tighter.push_back(counter->less_than(static_cast<unsigned>(count)));
+            if (check(tighter) != z3::sat) break;
+            result.matrix = extract_matrix(solver.get_model());
+            count = count_extensions(result.matrix);
+        }
+
+        if (config.incumbent) config.incumbent->offer(count);
+        return result;
+    }
+
+    // All frames of the pair, streamed to config.models. Blocking clauses
+    // range over the extension entries only: monotonicity fixes the rest,
+    // so two frames differ iff they differ there. Modulo symmetry, each
+    // model blocks its whole orbit under the pair's automorphisms. The
+    // solver is reused across models; the result carries the first frame.
+    TaskResult solve_enumerate(const Task& task) {
+        TaskResult result;
+        result.task = task;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SOLVER_TIMEOUT_MS);
+
+        z3::solver solver(state->ctx, "QF_FD");
+        set_internal_threads(solver);
+        encode_task(solver, task);
+
+        int ps = state->vars.size();
+        std::vector<std::pair<int, int>> free_entries;
+        for (int i = 0; i < ps; ++i) {
+            for (int j = 0; j < ps; ++j) {
+                if (!BitOps::is_subset(i, j)) free_entries.emplace_back(i, j);
+            }
+        }
+        std::vector<std::vector<int>> maps;
+        if (config.modulo_symmetry) {
+            maps = PairSymmetry::subset_maps(table.cells_of(task.partition1),
+                                             table.cells_of(task.partition2), table.universe_size());
+        } else {
+            std::vector<int> identity(ps);
+            for (int i = 0; i < ps; ++i) identity[i] = i;
+            maps.push_back(identity);
+        }
+
+        uint64_t count = 0;
+        const char* outcome = "complete";
+        while (true) {
+            if (config.model_limit > 0 && count >= config.model_limit) {
+                outcome = "limit";
+                break;
+            }
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            z3::check_result r = z3::unknown;
+            if (left > 0) {
+                z3::params p(state->ctx);
+                p.set("timeout", static_cast<unsigned>(left));
+                solver.set(p);
+                r = solver.check();
+            }
+            if (r == z3::unsat) break;
+            if (r == z3::unknown) {
+                outcome = "timeout";
+                if (count == 0) result.status = TaskStatus::TIMEOUT;
+                break;
+            }
+
+            auto matrix = extract_matrix(solver.get_model());
+            config.models->write_model(task.id, count, count_extensions(matrix), matrix);
+            if (count++ == 0) {
+                result.status = TaskStatus::SAT;
+                result.matrix = matrix;
+            }
+
+            // Block every image of this frame (distinct images only)
+            std::set<std::vector<bool>> blocked;
+            for (const auto& image : maps) {
+                // Image frame: R'[image(i)][image(j)] = R[i][j]
+                std::vector<bool> key(ps * ps);
+                z3::expr_vector clause(state->ctx);
+                for (const auto& [i, j] : free_entries) {
+                    key[image[i] * ps + image[j]] = matrix[i][j];
+                    z3::expr lit = state->vars.get_R(image[i], image[j]);
+                    clause.push_back(matrix[i][j] ? !lit : lit);
+                }
+                if (blocked.insert(key).second) solver.add(z3::mk_or(clause));
+            }
+        }
+        config.models->finish_task(task.id, count, outcome);
+        return result;
+    }
+
+    static int count_extensions(const std::vector<std::vector<bool>>& matrix) {
+        int count = 0;
+        int ps = static_cast<int>(matrix.size());
+        for (int i = 0; i < ps; ++i) {
+            for (int j = 0; j < ps; ++j) {
+                if (matrix[i][j] && !BitOps::is_subset(i, j)) ++count;
+            }
+        }
+        return count;
+    }
+
+    void set_internal_threads(z3::solver& solver) {
+        if (config.z3_threads <= 1) return;
+        // Not every Z3 build knows the parameter; stay sequential then
+        try {
+            z3::params p(state->ctx);
+            p.set("threads", config.z3_threads);
+            solver.set(p);
+        } catch (const z3::exception&) {
+        }
+    }
+
+    std::vector<std::vector<bool>> extract_matrix(const z3::model& m) {
+        int ps = state->vars.size();
+        std::vector<std::vector<bool>> matrix(ps, std::vector<bool>(ps));
+        for (int i = 0; i < ps; ++i) {
+            for (int j = 0; j < ps; ++j) {
+                matrix[i][j] = m.eval(state->vars.get_R(i, j)).is_true();
+            }
+        }
+        return matrix;
+    }
+};
+
+// ============================================================
+//  AutoTuner - Startup calibration of the worker pool
+// ============================================================
+//  Encodes one representative task (the pair with the most cells,
+//  i.e. the largest Not-Dilation/A2D encoding) in a scratch
+//  context, runs a short check, and measures the context's memory
+//  and encode/solve time. Worker count is the largest number of
+//  contexts that fits in available memory, capped by CPU count;
+//  CPUs left over go to Z3's internal threads when solving, not
+//  encoding, dominates.
+// ============================================================
+
+class AutoTuner {
+public:
+    struct Result {
+        int workers = 1;
+        unsigned z3_threads = 1;
+        size_t context_bytes = 0;     // Measured per-context footprint
+        size_t available_bytes = 0;   // Memory considered usable
+        double encode_ms = 0;
+        double solve_ms = 0;          // Capped at CALIBRATION_TIMEOUT_MS
+        bool solve_finished = false;
+    };
+
+private:
+    // Short check that lets the solver build its internal state
+    static constexpr unsigned CALIBRATION_TIMEOUT_MS = 10000;
+    // Fraction of available memory the pool may use
+    static constexpr double MEMORY_BUDGET = 0.8;
+    // Headroom on the measured footprint for harder tasks
+    static constexpr double CONTEXT_SAFETY = 1.5;
+
+    static size_t resident_bytes() {
+        std::ifstream in("/proc/self/statm");
+        size_t total = 0, resident = 0;
+        in >> total >> resident;
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    static size_t peak_resident_bytes() {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+    }
+
+    // MemAvailable, further capped by a cgroup v2 memory limit if present
+    static size_t available_memory() {
+        size_t available = 0;
+        std::ifstream meminfo("/proc/meminfo");
+        std::string key;
+        size_t value;
+        std::string unit;
+        while (meminfo >> key >> value >> unit) {
+            if (key == "MemAvailable:") {
+                available = value * 1024;
+                break;
+            }
+        }
+        std::ifstream cgroup("/sys/fs/cgroup/memory.max");
+        std::string limit;
+        if (cgroup >> limit && limit != "max") {
+            size_t cap = std::strtoull(limit.c_str(), nullptr, 10);
+            std::ifstream current_in("/sys/fs/cgroup/memory.current");
+            size_t current = 0;
+            current_in >> current;
+            if (cap > current && (available == 0 || cap - current < available)) {
+                available = cap - current;
+            }
+        }
+        return available;
+    }
+
+    static Task representative_task(const PartitionTable& table) {
+        int best = 0;
+        size_t best_cells = 0;
+        for (int k = 0; k < table.pair_count(); ++k) {
+            Task t = Task::from_index(table, k);
+            size_t cells = table.cells_of(t.partition1).size() + table.cells_of(t.partition2).size();
+            if (cells > best_cells) {
+                best_cells = cells;
+                best = k;
+            }
+        }
+        return Task::from_index(table, best);
+    }
+
+public:
+    // Measures one worker's context on the run's configuration: the
+    // TaskSolver applies the same engine, axiom and encoding choices
+    // (including those forced at n = 7) as the workers it sizes
+    static Result calibrate(const PartitionTable& table, int cpus, const SolverConfig& config) {
+        Result r;
+        if (cpus < 1) cpus = 1;
+        Task task = representative_task(table);
+        SolverConfig probe_config = config;
+        probe_config.z3_threads = 1;
+        probe_config.task_budget_mb = 0;
+
+        size_t rss_before = resident_bytes();
+        size_t peak_before = peak_resident_bytes();
+        int64_t z3_before = static_cast<int64_t>(Z3_get_estimated_alloc_size());
+        {
+            TaskSolver solver(table, probe_config);
+            TaskSolver::Probe probe = solver.probe(task, CALIBRATION_TIMEOUT_MS);
+            r.solve_finished = probe.finished;
+            r.encode_ms = probe.encode_ms;
+            r.solve_ms = probe.solve_ms;
+
+            int64_t z3_delta = static_cast<int64_t>(Z3_get_estimated_alloc_size()) - z3_before;
+            size_t rss_delta = resident_bytes() > rss_before ? resident_bytes() - rss_before : 0;
+            size_t peak_delta = peak_resident_bytes() > peak_before ? peak_resident_bytes() - peak_before : 0;
+            r.context_bytes = std::max({rss_delta, peak_delta,
+                                        static_cast<size_t>(std::max<int64_t>(z3_delta, 0))});
+        }
+
+        r.available_bytes = available_memory();
+        size_t per_worker = static_cast<size_t>(r.context_bytes * CONTEXT_SAFETY) + 1;
+        size_t budget = static_cast<size_t>(r.available_bytes * MEMORY_BUDGET);
+        long long fit = r.available_bytes > 0 ? static_cast<long long>(budget / per_worker) : cpus;
+        r.workers = static_cast<int>(std::max(1LL, std::min<long long>(cpus, fit)));
+
+        // Spare CPUs help only if solving dominates encoding (Z3 encodes
+        // sequentially); the native engine is single-threaded
+        int spare = cpus / r.workers;
+        bool solve_bound = config.engine == SolverEngine::Z3 &&
+                           (!r.solve_finished || r.solve_ms > 4 * r.encode_ms);
+        r.z3_threads = (spare >= 2 && solve_bound) ? static_cast<unsigned>(spare) : 1;
+        return r;
+    }
+
+    static void print(const Result& r, int cpus) {
+        auto mb = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "Auto-tune: context ~" << mb(r.context_bytes) << " MB, encode "
+                  << r.encode_ms << " ms, solve " << r.solve_ms << " ms"
+                  << (r.solve_finished ? "" : " (calibration timeout)") << "\n";
+        std::cout << "Auto-tune: " << mb(r.available_bytes) << " MB available, " << cpus
+                  << " CPU(s) -> " << r.workers << " worker(s) x " << r.z3_threads
+                  << " Z3 thread(s)\n";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+};
+
+// ============================================================
+//  SolverWorker - Worker thread that processes tasks
+// ============================================================
+
+class SolverWorker {
+    int worker_id;
+    int universe_size;
+    const PartitionTable& table;
+    TaskQueue& queue;
+    GlobalStopFlag& stop_flag;
+    std::atomic<int>& tasks_completed;
+    std::mutex& io_mutex;
+
+public:
+    SolverWorker(int id, const PartitionTable& pt, TaskQueue& q, GlobalStopFlag& sf, 
+                 std::atomic<int>& tc, std::mutex& iom)
+        : worker_id(id), universe_size(pt.universe_size()), table(pt), queue(q), stop_flag(sf),
+          tasks_completed(tc), io_mutex(iom) {}
+    
+    void run() {
         // Create thread-local Z3 context and variables
-        z3::context local_ctx;
-        FrameVariables local_vars(local_ctx, universe_size, /*silent=*/true);
-        AxiomEncoder encoder(local_vars, /*silent=*/true);
+        TaskSolver solver(table);
         
         Task task;
-        while (queue.try_pop(task)) {
-            // Create fresh solver for this task
-            z3::solver solver(local_ctx);
-            z3::params p(local_ctx);
-            p.set("timeout", SOLVER_TIMEOUT_MS);
-            solver.set(p);
+        while (!stop_flag.should_stop() && queue.try_pop(task)) {
+            TaskResult result = solver.solve(task);
             
-            // Encode common axioms
-            encoder.encode_common_axioms(solver);
+            // Check for early termination by another worker
+            if (stop_flag.should_stop()) {
+                return;
+            }
             
-            // Encode partition-specific axioms
-            encoder.encode_not_dilation(solver, task.partition1);
-            encoder.encode_not_dilation(solver, task.partition2);
-            encoder.encode_A2D(solver, task.partition1, task.partition2);
+            if (result.status == TaskStatus::SAT) {
+                stop_flag.report_solution(task.id, task, result.matrix, universe_size);
+                
+                {
+                    std::lock_guard<std::mutex> lock(io_mutex);
+                    std::cout << "[Worker " << worker_id << "] FOUND SOLUTION for task " 
+                              << task.id << "!\n";
+                }
+                return;
+            }
             
-            // Solve (single attempt with long timeout)
-            z3::check_result result = solver.check();
+            // Task completed (UNSAT or TIMEOUT) - move on to next task
+            int completed = ++tasks_completed;
+            if (!stop_flag.should_stop()) {
+                std::lock_guard<std::mutex> lock(io_mutex);
+                std::cout << "[Worker " << worker_id << "] Task " << task.id 
+                          << " completed (" << status_name(result.status)
+                          << "). Progress: " << completed << " tasks done.\n";
+            }
+        }
+    }
+};
+
+// ============================================================
+//  ExhaustiveWorker - Worker that processes ALL tasks (no early stop)
+// ============================================================
+
+class ExhaustiveWorker {
+    int worker_id;
+    int universe_size;
+    const PartitionTable& table;
+    TaskQueue& queue;
+    SolutionCollector& collector;
+    std::atomic<int>& tasks_completed;
+    std::atomic<int>& tasks_total;
+    std::mutex& io_mutex;
+    ResultFile* result_file;    // Optional: every result is appended here
+    SolverConfig config;
+    std::atomic<int>& tasks_pruned;
+
+public:
+    ExhaustiveWorker(int id, const PartitionTable& pt, TaskQueue& q, SolutionCollector& sc,
+                     std::atomic<int>& tc, std::atomic<int>& tt, std::mutex& iom,
+                     ResultFile* rf, const SolverConfig& cfg, std::atomic<int>& tp)
+        : worker_id(id), universe_size(pt.universe_size()), table(pt), queue(q), collector(sc),
+          tasks_completed(tc), tasks_total(tt), io_mutex(iom), result_file(rf), config(cfg),
+          tasks_pruned(tp) {}
+    
+    void run() {
+        // Create thread-local Z3 context and variables
+        TaskSolver solver(table, config);
+        // Collected frames are tested with the native kernels (n <= 6)
+        bool reuse = config.model_reuse && universe_size <= NativeFrame::MAX_UNIVERSE;
+        FrameKernels kernels = reuse ? FrameKernels::for_universe(universe_size) : FrameKernels{};
+        
+        Task task;
+        while (queue.try_pop(task)) {
+            TaskResult result;
+            result.task = task;
+            bool decided = config.core_facts && config.core_facts->dominated(task);  // UNSAT
+            if (!decided && reuse) {
+                result.matrix = collector.find_witness(kernels, table.cells_of(task.partition1),
+                                                       table.cells_of(task.partition2), universe_size);
+                decided = !result.matrix.empty();
+                if (decided) result.status = TaskStatus::SAT;
+            }
+            if (!decided) result = solver.solve(task);
+            if (result_file) result_file->append(result);
+            if (result.status == TaskStatus::PRUNED) ++tasks_pruned;
             
-            if (result == z3::sat) {
-                // Extract matrix
-                z3::model m = solver.get_model();
-                int ps = local_vars.size();
-                std::vector<std::vector<bool>> matrix(ps, std::vector<bool>(ps));
-                for (int i = 0; i < ps; ++i) {
-                    for (int j = 0; j < ps; ++j) {
-                        matrix[i][j] = m.eval(local_vars.get_R(i, j)).is_true();
-                    }
-                }
-                
+            if (result.status == TaskStatus::SAT) {
                 // Add to collector
-                collector.add_solution(task.id, task, matrix, universe_size);
+                collector.add_solution(task.id, task, result.matrix, universe_size);
                 
                 {
                     std::lock_guard<std::mutex> lock(io_mutex);
@@ -1109,14 +4745,572 @@ public:
             {
                 std::lock_guard<std::mutex> lock(io_mutex);
                 std::cout << "[Worker " << worker_id << "] Task " << task.id 
-                          << " done (" << (result == z3::sat ? "SAT" : 
-                                           result == z3::unsat ? "UNSAT" : "TIMEOUT")
+                          << " done (" << status_name(result.status)
                           << "). Progress: " << completed << "/" << total << "\n";
             }
         }
     }
 };
 
+// ============================================================
+//  ProcessPool - Forked worker processes with crash isolation
+// ============================================================
+//  Each worker is a forked child owning its own Z3 context (and
+//  therefore its own allocator heap) under an optional RLIMIT_AS
+//  cap. The orchestrator hands out one task id at a time over a
+//  pipe and reads binary result records back, so a crash loses
+//  only the task in flight: it is retried once, then recorded as
+//  CRASHED, and the worker slot is respawned.
+// ============================================================
+
+class ProcessPool {
+    struct Slot {
+        pid_t pid = -1;
+        int cmd_fd = -1;     // Orchestrator -> worker: int32 task ids, -1 = exit
+        int res_fd = -1;     // Worker -> orchestrator: result records
+        int task_id = -1;    // Task in flight, -1 when idle
+    };
+
+    const PartitionTable& table;
+    int num_procs;
+    size_t mem_limit_mb;     // Per-process address-space cap, 0 = unlimited
+    std::vector<Slot> slots;
+    std::vector<int> slot_cpus;  // Optional CPU per slot (see CpuTopology)
+    SolverConfig config;
+
+    // Attempts per task before a crashing task is given up as CRASHED
+    static constexpr int MAX_ATTEMPTS = 2;
+
+public:
+    using ResultHandler = std::function<void(int worker, const TaskResult&)>;
+
+    ProcessPool(const PartitionTable& pt, int procs, size_t mem_mb,
+                const SolverConfig& cfg = SolverConfig())
+        : table(pt), num_procs(procs > 0 ? procs : 1), mem_limit_mb(mem_mb),
+          slots(num_procs), config(cfg) {}
+
+    // Pin worker k (and its respawns) to cpus[k % cpus.size()]
+    void set_cpus(const std::vector<int>& cpus) { slot_cpus = cpus; }
+
+    // Solve every task in task_ids; on_result runs in the orchestrator
+    // for each final result, in completion order
+    void run(const std::vector<int>& task_ids, const ResultHandler& on_result) {
+        // A dead worker must not take the orchestrator down on write
+        signal(SIGPIPE, SIG_IGN);
+
+        std::deque<int> pending(task_ids.begin(), task_ids.end());
+        std::map<int, int> attempts;
+        size_t outstanding = 0;
+
+        for (int k = 0; k < num_procs; ++k) spawn(k);
+
+        while (!pending.empty() || outstanding > 0) {
+            // Hand out work to idle workers
+            for (int k = 0; k < num_procs; ++k) {
+                Slot& slot = slots[k];
+                if (slot.pid < 0 && !pending.empty()) spawn(k);
+                if (slot.pid < 0 || slot.task_id >= 0 || pending.empty()) continue;
+                int32_t id = pending.front();
+                pending.pop_front();
+                slot.task_id = id;
+                ++outstanding;
+                // A failed write surfaces as EOF on the result pipe below
+                RecordIO::write_all(slot.cmd_fd, &id, sizeof(id));
+            }
+
+            std::vector<pollfd> fds;
+            std::vector<int> fd_slot;
+            for (int k = 0; k < num_procs; ++k) {
+                if (slots[k].pid < 0) continue;
+                fds.push_back(pollfd{slots[k].res_fd, POLLIN, 0});
+                fd_slot.push_back(k);
+            }
+            if (fds.empty()) break;
+            if (poll(fds.data(), fds.size(), -1) < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "ProcessPool: poll failed: " << std::strerror(errno) << "\n";
+                break;
+            }
+
+            for (size_t f = 0; f < fds.size(); ++f) {
+                if (fds[f].revents == 0) continue;
+                int k = fd_slot[f];
+                Slot& slot = slots[k];
+
+                TaskResult result;
+                if (RecordIO::read_record(slot.res_fd, result)) {
+                    if (slot.task_id >= 0) --outstanding;
+                    slot.task_id = -1;
+                    on_result(k, result);
+                    continue;
+                }
+
+                // EOF: the worker exited or crashed
+                int status = reap(k);
+                if (slot.task_id < 0) continue;  // Idle worker exited (e.g. after MEMOUT)
+
+                int id = slot.task_id;
+                slot.task_id = -1;
+                --outstanding;
+                std::cout << "[Process " << k << "] crashed on task " << id << " ("
+                          << describe_exit(status) << ")\n";
+                if (++attempts[id] < MAX_ATTEMPTS) {
+                    pending.push_front(id);
+                } else {
+                    TaskResult crashed;
+                    crashed.task = Task::from_index(table, id);
+                    crashed.status = TaskStatus::CRASHED;
+                    on_result(k, crashed);
+                }
+            }
+        }
+
+        // Shut down remaining workers
+        for (int k = 0; k < num_procs; ++k) {
+            if (slots[k].pid < 0) continue;
+            int32_t stop = -1;
+            RecordIO::write_all(slots[k].cmd_fd, &stop, sizeof(stop));
+            reap(k);
+        }
+    }
+
+private:
+    void spawn(int k) {
+        int cmd[2], res[2];
+        if (pipe(cmd) != 0 || pipe(res) != 0) {
+            std::cerr << "ProcessPool: pipe failed: " << std::strerror(errno) << "\n";
+            std::exit(1);
+        }
+        std::cout.flush();
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::cerr << "ProcessPool: fork failed: " << std::strerror(errno) << "\n";
+            std::exit(1);
+        }
+        if (pid == 0) {
+            // Child: drop every orchestrator-side descriptor so that EOF
+            // on another worker's pipe is seen when that worker dies
+            for (const Slot& other : slots) {
+                if (other.pid < 0) continue;
+                close(other.cmd_fd);
+                close(other.res_fd);
+            }
+            close(cmd[1]);
+            close(res[0]);
+            if (!slot_cpus.empty()) {
+                CpuTopology::pin_current_thread(slot_cpus[k % slot_cpus.size()]);
+            }
+            worker_main(cmd[0], res[1]);
+        }
+        close(cmd[0]);
+        close(res[1]);
+        slots[k].pid = pid;
+        slots[k].cmd_fd = cmd[1];
+        slots[k].res_fd = res[0];
+        slots[k].task_id = -1;
+    }
+
+    int reap(int k) {
+        Slot& slot = slots[k];
+        close(slot.cmd_fd);
+        close(slot.res_fd);
+        int status = 0;
+        waitpid(slot.pid, &status, 0);
+        slot.pid = -1;
+        slot.cmd_fd = slot.res_fd = -1;
+        return status;
+    }
+
+    static std::string describe_exit(int status) {
+        std::ostringstream oss;
+        if (WIFSIGNALED(status)) {
+            oss << "signal " << WTERMSIG(status);
+        } else {
+            oss << "exit code " << WEXITSTATUS(status);
+        }
+        return oss.str();
+    }
+
+    [[noreturn]] void worker_main(int cmd_fd, int res_fd) {
+        if (mem_limit_mb > 0) {
+            rlimit limit;
+            limit.rlim_cur = limit.rlim_max = static_cast<rlim_t>(mem_limit_mb) << 20;
+            setrlimit(RLIMIT_AS, &limit);
+            // Let Z3 fail gracefully just below the hard limit
+            z3::set_param("memory_max_size", static_cast<int>(mem_limit_mb * 9 / 10));
+        }
+
+        std::unique_ptr<TaskSolver> solver;
+        int32_t id;
+        while (RecordIO::read_all(cmd_fd, &id, sizeof(id)) && id >= 0) {
+            TaskResult result;
+            result.task = Task::from_index(table, id);
+            bool exit_after = false;
+            try {
+                if (!solver) solver.reset(new TaskSolver(table, config));
+                result = solver->solve(result.task);
+            } catch (const z3::exception& e) {
+                result.status = std::strstr(e.msg(), "memory") ? TaskStatus::MEMOUT
+                                                                : TaskStatus::CRASHED;
+                exit_after = true;
+            } catch (const std::bad_alloc&) {
+                result.status = TaskStatus::MEMOUT;
+                exit_after = true;
+            }
+            // The context may be unusable after an allocation failure:
+            // report, then exit and let the orchestrator respawn us
+            if (!RecordIO::write_record(res_fd, result, table.universe_size())) break;
+            if (exit_after) break;
+        }
+        _exit(0);
+    }
+};
+
+// ============================================================
+//  Net - Minimal TCP helpers for coordinator/worker mode
+// ============================================================
+
+namespace Net {
+
+    // Listen on all interfaces; returns fd or -1
+    int listen_tcp(int port) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(fd, 64) != 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // Connect to host:port; returns fd or -1
+    int connect_tcp(const std::string& host, const std::string& port) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* res = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0) return -1;
+        int fd = -1;
+        for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0) continue;
+            if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+            close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(res);
+        if (fd >= 0) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        return fd;
+    }
+
+    // Bound blocking reads so a stalled peer cannot hang the coordinator
+    void set_recv_timeout(int fd, int seconds) {
+        timeval tv{};
+        tv.tv_sec = seconds;
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+
+    std::string peer_name(int fd) {
+        sockaddr_storage addr{};
+        socklen_t len = sizeof(addr);
+        char host[NI_MAXHOST] = "?", serv[NI_MAXSERV] = "?";
+        if (getpeername(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0) {
+            getnameinfo(reinterpret_cast<sockaddr*>(&addr), len, host, sizeof(host),
+                        serv, sizeof(serv), NI_NUMERICHOST | NI_NUMERICSERV);
+        }
+        return std::string(host) + ":" + serv;
+    }
+}
+
+// ============================================================
+//  Coordinator protocol
+// ============================================================
+//  worker -> coordinator : Hello, then one RecordIO record per task
+//  coordinator -> worker : Welcome (universe size and frame class),
+//                          then one int32 per assignment: task id,
+//                          or ASSIGN_DONE
+//  Workers whose --total setting asks for a different frame class
+//  than the coordinator's hang up instead of solving.
+//  A worker holds at most one lease. Leases that outlive
+//  lease_timeout are handed to another worker; the first result
+//  to arrive for a task wins and later duplicates are dropped.
+// ============================================================
+
+namespace CoordinatorProtocol {
+    constexpr uint32_t MAGIC = 0x46464631;   // "FFF1"
+    constexpr int32_t ASSIGN_DONE = -1;
+
+    struct Hello   { uint32_t magic; uint32_t reserved; };
+    struct Welcome { uint32_t magic; int32_t universe_size; int32_t total; };
+}
+
+// ============================================================
+//  TaskCoordinator - Serves task ids over TCP, collects results
+// ============================================================
+//  Single-threaded poll loop; never touches Z3.
+// ============================================================
+
+class TaskCoordinator {
+    struct Connection {
+        int fd = -1;
+        std::string name;
+        bool greeted = false;
+        int task_id = -1;                                 // Current lease, -1 = waiting
+        std::chrono::steady_clock::time_point deadline;
+        bool lease_expired = false;
+    };
+
+    const PartitionTable& table;
+    int port;
+    std::chrono::seconds lease_timeout;
+    bool total;                                           // Frames are total preorders
+
+    // Maximum time a single message may take to arrive once started
+    static constexpr int RECV_TIMEOUT_S = 30;
+
+public:
+    using ResultHandler = std::function<void(const std::string& worker, const TaskResult&)>;
+
+    TaskCoordinator(const PartitionTable& pt, int listen_port, int lease_timeout_s, bool total_frames)
+        : table(pt), port(listen_port), lease_timeout(lease_timeout_s), total(total_frames) {}
+
+    // Serve task_ids until every one has a result; false if the port cannot be bound
+    bool run(const std::vector<int>& task_ids, const ResultHandler& on_result) {
+        using namespace CoordinatorProtocol;
+        signal(SIGPIPE, SIG_IGN);
+
+        int listen_fd = Net::listen_tcp(port);
+        if (listen_fd < 0) {
+            std::cerr << "Coordinator: cannot listen on port " << port << ": "
+                      << std::strerror(errno) << "\n";
+            return false;
+        }
+        std::cout << "[Coordinator] Listening on port " << port << " (lease timeout "
+                  << lease_timeout.count() << " s)\n";
+
+        std::deque<int> pending(task_ids.begin(), task_ids.end());
+        std::map<int, bool> done;            // task id -> result recorded
+        for (int id : task_ids) done[id] = false;
+        size_t remaining = task_ids.size();
+        std::vector<Connection> conns;
+
+        auto release = [&](Connection& c) {
+            if (c.task_id >= 0 && !done[c.task_id] && !c.lease_expired) {
+                pending.push_front(c.task_id);
+            }
+            c.task_id = -1;
+            c.lease_expired = false;
+        };
+
+        auto drop = [&](size_t idx, const char* why) {
+            Connection& c = conns[idx];
+            std::cout << "[Coordinator] Worker " << c.name << " " << why;
+            if (c.task_id >= 0 && !done[c.task_id]) std::cout << "; task " << c.task_id << " re-queued";
+            std::cout << "\n";
+            release(c);
+            close(c.fd);
+            conns.erase(conns.begin() + idx);
+        };
+
+        while (remaining > 0) {
+            auto now = std::chrono::steady_clock::now();
+
+            // Re-queue expired leases; the late worker may still answer
+            for (auto& c : conns) {
+                if (c.task_id >= 0 && !c.lease_expired && !done[c.task_id] && now > c.deadline) {
+                    std::cout << "[Coordinator] Lease on task " << c.task_id << " held by "
+                              << c.name << " expired; reassigning\n";
+                    pending.push_back(c.task_id);
+                    c.lease_expired = true;
+                }
+            }
+
+            // Assign work to waiting workers
+            for (size_t i = 0; i < conns.size(); ) {
+                Connection& c = conns[i];
+                while (!pending.empty() && done[pending.front()]) pending.pop_front();
+                if (!c.greeted || c.task_id >= 0 || pending.empty()) { ++i; continue; }
+                int32_t id = pending.front();
+                pending.pop_front();
+                c.task_id = id;
+                c.lease_expired = false;
+                c.deadline = now + lease_timeout;
+                if (!RecordIO::write_all(c.fd, &id, sizeof(id))) {
+                    drop(i, "disconnected");
+                    continue;
+                }
+                ++i;
+            }
+
+            std::vector<pollfd> fds;
+            fds.push_back(pollfd{listen_fd, POLLIN, 0});
+            for (const auto& c : conns) fds.push_back(pollfd{c.fd, POLLIN, 0});
+            // Wake up periodically to check lease deadlines
+            if (poll(fds.data(), fds.size(), 1000) < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "Coordinator: poll failed: " << std::strerror(errno) << "\n";
+                break;
+            }
+
+            // Handle existing connections back to front so erasing is safe
+            for (size_t f = fds.size() - 1; f >= 1; --f) {
+                if (fds[f].revents == 0) continue;
+                size_t idx = f - 1;
+                Connection& c = conns[idx];
+
+                if (!c.greeted) {
+                    Hello hello;
+                    if (!RecordIO::read_all(c.fd, &hello, sizeof(hello)) || hello.magic != MAGIC) {
+                        drop(idx, "sent a bad greeting");
+                        continue;
+                    }
+                    Welcome welcome{MAGIC, table.universe_size(), total ? 1 : 0};
+                    if (!RecordIO::write_all(c.fd, &welcome, sizeof(welcome))) {
+                        drop(idx, "disconnected");
+                        continue;
+                    }
+                    c.greeted = true;
+                    std::cout << "[Coordinator] Worker " << c.name << " joined\n";
+                    continue;
+                }
+
+                TaskResult result;
+                int n = 0;
+                if (!RecordIO::read_record(c.fd, result, &n) || n != table.universe_size()) {
+                    drop(idx, "disconnected");
+                    continue;
+                }
+                int id = result.task.id;
+                if (c.task_id == id) {
+                    c.task_id = -1;
+                    c.lease_expired = false;
+                }
+                auto it = done.find(id);
+                if (it == done.end() || it->second) continue;  // Unknown or duplicate
+                it->second = true;
+                --remaining;
+                on_result(c.name, result);
+            }
+
+            if (fds[0].revents & POLLIN) {
+                int fd = accept(listen_fd, nullptr, nullptr);
+                if (fd >= 0) {
+                    Net::set_recv_timeout(fd, RECV_TIMEOUT_S);
+                    Connection c;
+                    c.fd = fd;
+                    c.name = Net::peer_name(fd);
+                    conns.push_back(c);
+                }
+            }
+        }
+
+        // Tell everyone we are done
+        for (auto& c : conns) {
+            int32_t stop = ASSIGN_DONE;
+            RecordIO::write_all(c.fd, &stop, sizeof(stop));
+            close(c.fd);
+        }
+        close(listen_fd);
+        return true;
+    }
+};
+
+// ============================================================
+//  RemoteWorker - Worker mode connecting to a TaskCoordinator
+// ============================================================
+//  Each thread holds its own connection and TaskSolver. The
+//  universe size is taken from the coordinator's Welcome; a
+//  frame class that differs from --total is refused.
+// ============================================================
+
+class RemoteWorker {
+    std::string host;
+    std::string port;
+    int num_threads;
+    SolverConfig config;
+    std::mutex io_mutex;
+
+public:
+    RemoteWorker(const std::string& address, int threads, const SolverConfig& cfg = SolverConfig())
+        : num_threads(threads > 0 ? threads : 1), config(cfg) {
+        size_t colon = address.rfind(':');
+        host = colon == std::string::npos ? "127.0.0.1" : address.substr(0, colon);
+        port = colon == std::string::npos ? address : address.substr(colon + 1);
+    }
+
+    // Returns number of tasks solved by this process, -1 if no connection succeeded
+    int run() {
+        signal(SIGPIPE, SIG_IGN);
+        std::atomic<int> solved{0};
+        std::atomic<int> connected{0};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_threads; ++i) {
+            threads.emplace_back([this, i, &solved, &connected]() {
+                serve(i, solved, connected);
+            });
+        }
+        for (auto& t : threads) t.join();
+        return connected.load() > 0 ? solved.load() : -1;
+    }
+
+private:
+    void serve(int worker_id, std::atomic<int>& solved, std::atomic<int>& connected) {
+        using namespace CoordinatorProtocol;
+
+        int fd = Net::connect_tcp(host, port);
+        if (fd < 0) {
+            std::lock_guard<std::mutex> lock(io_mutex);
+            std::cerr << "[Worker " << worker_id << "] cannot connect to " << host << ":" << port << "\n";
+            return;
+        }
+        Hello hello{MAGIC, 0};
+        Welcome welcome;
+        if (!RecordIO::write_all(fd, &hello, sizeof(hello)) ||
+            !RecordIO::read_all(fd, &welcome, sizeof(welcome)) ||
+            welcome.magic != MAGIC || welcome.universe_size < 2 ||
+            welcome.universe_size > SetTables::MAX_UNIVERSE) {
+            std::lock_guard<std::mutex> lock(io_mutex);
+            std::cerr << "[Worker " << worker_id << "] handshake with coordinator failed\n";
+            close(fd);
+            return;
+        }
+        if ((welcome.total != 0) != (config.totality != Totality::OFF)) {
+            std::lock_guard<std::mutex> lock(io_mutex);
+            std::cerr << "[Worker " << worker_id << "] coordinator searches "
+                      << (welcome.total ? "total" : "non-total")
+                      << " frames; restart this worker with matching --total\n";
+            close(fd);
+            return;
+        }
+        ++connected;
+
+        PartitionTable table(welcome.universe_size);
+        std::unique_ptr<TaskSolver> solver;
+        int32_t id;
+        while (RecordIO::read_all(fd, &id, sizeof(id)) && id != ASSIGN_DONE) {
+            if (id < 0 || id >= table.pair_count()) break;
+            if (!solver) solver.reset(new TaskSolver(table, config));
+            TaskResult result = solver->solve(Task::from_index(table, id));
+            if (!RecordIO::write_record(fd, result, table.universe_size())) break;
+            ++solved;
+            std::lock_guard<std::mutex> lock(io_mutex);
+            std::cout << "[Worker " << worker_id << "] Task " << id
+                      << " done (" << status_name(result.status) << ")\n";
+        }
+        close(fd);
+    }
+};
+
 // ============================================================
 //  ParallelFrameFinder - Orchestrates parallel search
 // ============================================================
@@ -1124,6 +5318,7 @@ public:
 class ParallelFrameFinder {
     int universe_size;
     int num_threads;
+    PartitionTable table;
     TaskQueue queue;
     GlobalStopFlag stop_flag;
     std::vector<std::thread> workers;
@@ -1133,7 +5328,8 @@ class ParallelFrameFinder {
 public:
     ParallelFrameFinder(int n, int threads = 0)
         : universe_size(n), 
-          num_threads(threads > 0 ? threads : std::thread::hardware_concurrency()) {
+          num_threads(threads > 0 ? threads : std::thread::hardware_concurrency()),
+          table(n) {
         if (num_threads == 0) num_threads = 4;  // Fallback
     }
     
@@ -1143,20 +5339,20 @@ public:
         
         // Generate all partition pairs
         std::cout << "Generating partition pairs for universe size " << universe_size << "...\n";
-        auto pairs = PartitionEnumerator::generate_partition_pairs(universe_size);
-        std::cout << "Generated " << pairs.size() << " partition pairs\n";
+        int num_pairs = table.pair_count();
+        std::cout << "Generated " << num_pairs << " partition pairs\n";
         std::cout << "Using " << num_threads << " worker threads\n\n";
         
         // Populate task queue
-        for (size_t i = 0; i < pairs.size(); ++i) {
-            queue.push(Task{static_cast<int>(i), pairs[i].first, pairs[i].second});
+        for (int k = 0; k < num_pairs; ++k) {
+            queue.push(Task::from_index(table, k));
         }
         queue.mark_finished();
         
         // Launch workers
         for (int i = 0; i < num_threads; ++i) {
             workers.emplace_back([this, i]() {
-                SolverWorker worker(i, universe_size, queue, stop_flag, 
+                SolverWorker worker(i, table, queue, stop_flag, 
                                     tasks_completed, io_mutex);
                 worker.run();
             });
@@ -1172,7 +5368,7 @@ public:
         
         std::cout << "\n=== SEARCH COMPLETE ===\n";
         std::cout << "Total time: " << duration.count() << " ms\n";
-        std::cout << "Tasks completed: " << tasks_completed.load() << "/" << pairs.size() << "\n";
+        std::cout << "Tasks completed: " << tasks_completed.load() << "/" << num_pairs << "\n";
         
         return stop_flag.has_solution();
     }
@@ -1191,8 +5387,8 @@ public:
         
         std::cout << "\n=== WINNING SOLUTION ===\n";
         std::cout << "Task ID: " << task.id << "\n";
-        std::cout << "Partition I1: " << BitOps::partition_to_string(task.partition1, n) << "\n";
-        std::cout << "Partition I2: " << BitOps::partition_to_string(task.partition2, n) << "\n";
+        std::cout << "Partition I1: " << BitOps::partition_to_string(table.cells_of(task.partition1), n) << "\n";
+        std::cout << "Partition I2: " << BitOps::partition_to_string(table.cells_of(task.partition2), n) << "\n";
         
         // Compute minimal monotonic relation (i ⊆ j)
         std::vector<std::vector<bool>> minimal(ps, std::vector<bool>(ps, false));
@@ -1253,7 +5449,7 @@ public:
                   << extension_count << " entries (marked with '+')\n";
         
         // Verify solution
-        verify_solution(matrix, task, n);
+        verify_solution(matrix, table.cells_of(task.partition1), table.cells_of(task.partition2), n);
         
         // Natural language description (decoupled analysis)
         ModelAnalyzer::describe_model(matrix, n);
@@ -1261,7 +5457,7 @@ public:
 
 private:
     void verify_solution(const std::vector<std::vector<bool>>& matrix, 
-                         const Task& task, int n) {
+                         CellSpan I1, CellSpan I2, int n) {
         int ps = static_cast<int>(matrix.size());
         std::cout << "\n=== VERIFICATION ===\n";
         
@@ -1303,18 +5499,12 @@ private:
         
         // Check CSTP
         bool cstp_ok = true;
-        for (int A = 0; A < ps && cstp_ok; ++A) {
-            for (int B = 0; B < ps && cstp_ok; ++B) {
-                if (BitOps::set_intersection(A, B) != 0) continue;
-                for (int C = 0; C < ps && cstp_ok; ++C) {
-                    for (int D = 0; D < ps && cstp_ok; ++D) {
-                        if (BitOps::set_intersection(C, D) != 0) continue;
-                        int AB = BitOps::set_union(A, B);
-                        int CD = BitOps::set_union(C, D);
-                        if (matrix[A][C] && matrix[B][D] && !matrix[AB][CD]) {
-                            cstp_ok = false;
-                        }
-                    }
+        for (const auto& ab : SetTables::disjoint_pairs(ps)) {         // A and B disjoint
+            int A = ab.a, B = ab.b, AB = A | B;
+            for (const auto& cd : SetTables::disjoint_pairs(ps)) {     // C and D disjoint
+                int C = cd.a, D = cd.b, CD = C | D;
+                if (matrix[A][C] && matrix[B][D] && !matrix[AB][CD]) {
+                    cstp_ok = false;
                 }
             }
         }
@@ -1322,28 +5512,22 @@ private:
         
         // Check Strict CSTP
         bool strict_cstp_ok = true;
-        for (int A = 0; A < ps && strict_cstp_ok; ++A) {
-            for (int B = 0; B < ps && strict_cstp_ok; ++B) {
-                if (BitOps::set_intersection(A, B) != 0) continue;
-                for (int C = 0; C < ps && strict_cstp_ok; ++C) {
-                    for (int D = 0; D < ps && strict_cstp_ok; ++D) {
-                        if (BitOps::set_intersection(C, D) != 0) continue;
-                        int AB = BitOps::set_union(A, B);
-                        int CD = BitOps::set_union(C, D);
-                        bool A_less_C = matrix[A][C] && !matrix[C][A];
-                        bool B_less_D = matrix[B][D] && !matrix[D][B];
-                        bool AB_less_CD = matrix[AB][CD] && !matrix[CD][AB];
-                        if (A_less_C && B_less_D && !AB_less_CD) {
-                            strict_cstp_ok = false;
-                        }
-                    }
+        for (const auto& ab : SetTables::disjoint_pairs(ps)) {         // A and B disjoint
+            int A = ab.a, B = ab.b, AB = A | B;
+            for (const auto& cd : SetTables::disjoint_pairs(ps)) {     // C and D disjoint
+                int C = cd.a, D = cd.b, CD = C | D;
+                bool A_less_C = matrix[A][C] && !matrix[C][A];
+                bool B_less_D = matrix[B][D] && !matrix[D][B];
+                bool AB_less_CD = matrix[AB][CD] && !matrix[CD][AB];
+                if (A_less_C && B_less_D && !AB_less_CD) {
+                    strict_cstp_ok = false;
                 }
             }
         }
         std::cout << "Strict CSTP: " << (strict_cstp_ok ? "PASS" : "FAIL") << "\n";
         
         // Check Not Dilation for I1 and I2
-        auto check_not_dilation = [&](const std::vector<int>& partition, const std::string& name) {
+        auto check_not_dilation = [&](CellSpan partition, const std::string& name) {
             bool ok = true;
             for (int E = 0; E < ps && ok; ++E) {
                 for (int F = 0; F < ps && ok; ++F) {
@@ -1365,8 +5549,8 @@ private:
             std::cout << "Not Dilation (" << name << "): " << (ok ? "PASS" : "FAIL") << "\n";
         };
         
-        check_not_dilation(task.partition1, "I1");
-        check_not_dilation(task.partition2, "I2");
+        check_not_dilation(I1, "I1");
+        check_not_dilation(I2, "I2");
     }
 };
 
@@ -1519,25 +5703,19 @@ private:
         int ps = vars.size();
         bool cstp_ok = true;
 
-        for (int A = 0; A < ps; ++A) {
-            for (int B = 0; B < ps; ++B) {
-                if (BitOps::set_intersection(A, B) != 0) continue; // A and B must be disjoint
-                for (int C = 0; C < ps; ++C) {
-                    for (int D = 0; D < ps; ++D) {
-                        if (BitOps::set_intersection(C, D) != 0) continue; // C and D must be disjoint
-                        int AB = BitOps::set_union(A, B);
-                        int CD = BitOps::set_union(C, D);
-                        if (matrix[A][C] && matrix[B][D] && !matrix[AB][CD]) {
-                            cstp_ok = false;
-                            std::cout << "CSTP violation: "
-                                      << BitOps::to_string(A, vars.universe_size()) << " <= "
-                                      << BitOps::to_string(C, vars.universe_size()) << " and "
-                                      << BitOps::to_string(B, vars.universe_size()) << " ≤ "
-                                      << BitOps::to_string(D, vars.universe_size())
-                                      << " but not " << BitOps::to_string(AB, vars.universe_size())
-                                      << " ≤ " << BitOps::to_string(CD, vars.universe_size()) << "\n";
-                        }
-                    }
+        for (const auto& ab : SetTables::disjoint_pairs(ps)) {         // A and B disjoint
+            int A = ab.a, B = ab.b, AB = A | B;
+            for (const auto& cd : SetTables::disjoint_pairs(ps)) {     // C and D disjoint
+                int C = cd.a, D = cd.b, CD = C | D;
+                if (matrix[A][C] && matrix[B][D] && !matrix[AB][CD]) {
+                    cstp_ok = false;
+                    std::cout << "CSTP violation: "
+                              << BitOps::to_string(A, vars.universe_size()) << " <= "
+                              << BitOps::to_string(C, vars.universe_size()) << " and "
+                              << BitOps::to_string(B, vars.universe_size()) << " ≤ "
+                              << BitOps::to_string(D, vars.universe_size())
+                              << " but not " << BitOps::to_string(AB, vars.universe_size())
+                              << " ≤ " << BitOps::to_string(CD, vars.universe_size()) << "\n";
                 }
             }
         }
@@ -1549,28 +5727,22 @@ private:
         int ps = vars.size();
         bool strict_cstp_ok = true;
 
-        for (int A = 0; A < ps; ++A) {
-            for (int B = 0; B < ps; ++B) {
-                if (BitOps::set_intersection(A, B) != 0) continue; // A and B must be disjoint
-                for (int C = 0; C < ps; ++C) {
-                    for (int D = 0; D < ps; ++D) {
-                        if (BitOps::set_intersection(C, D) != 0) continue; // C and D must be disjoint
-                        int AB = BitOps::set_union(A, B);
-                        int CD = BitOps::set_union(C, D);
-                        bool A_less_C = matrix[A][C] && !matrix[C][A];
-                        bool B_less_D = matrix[B][D] && !matrix[D][B];
-                        bool AB_less_CD = matrix[AB][CD] && !matrix[CD][AB];
-                        if (A_less_C && B_less_D && !AB_less_CD) {
-                            strict_cstp_ok = false;
-                            std::cout << "Strict CSTP violation: "
-                                      << BitOps::to_string(A, vars.universe_size()) << " < "
-                                      << BitOps::to_string(C, vars.universe_size()) << " and "
-                                      << BitOps::to_string(B, vars.universe_size()) << " < "
-                                      << BitOps::to_string(D, vars.universe_size())
-                                      << " but not " << BitOps::to_string(AB, vars.universe_size())
-                                      << " < " << BitOps::to_string(CD, vars.universe_size()) << "\n";
-                        }
-                    }
+        for (const auto& ab : SetTables::disjoint_pairs(ps)) {         // A and B disjoint
+            int A = ab.a, B = ab.b, AB = A | B;
+            for (const auto& cd : SetTables::disjoint_pairs(ps)) {     // C and D disjoint
+                int C = cd.a, D = cd.b, CD = C | D;
+                bool A_less_C = matrix[A][C] && !matrix[C][A];
+                bool B_less_D = matrix[B][D] && !matrix[D][B];
+                bool AB_less_CD = matrix[AB][CD] && !matrix[CD][AB];
+                if (A_less_C && B_less_D && !AB_less_CD) {
+                    strict_cstp_ok = false;
+                    std::cout << "Strict CSTP violation: "
+                              << BitOps::to_string(A, vars.universe_size()) << " < "
+                              << BitOps::to_string(C, vars.universe_size()) << " and "
+                              << BitOps::to_string(B, vars.universe_size()) << " < "
+                              << BitOps::to_string(D, vars.universe_size())
+                              << " but not " << BitOps::to_string(AB, vars.universe_size())
+                              << " < " << BitOps::to_string(CD, vars.universe_size()) << "\n";
                 }
             }
         }
@@ -1592,7 +5764,7 @@ namespace WitnessExtractor {
     void extract_dilation_witnesses(
         const z3::model& model,
         const FrameVariables& vars,
-        const std::vector<int>& partition
+        CellSpan partition
     ) {
         int ps = vars.size();
         int n = vars.universe_size();
@@ -1649,50 +5821,165 @@ namespace WitnessExtractor {
 class ExhaustiveFrameFinder {
     int universe_size;
     int num_threads;
+    PartitionTable table;
     TaskQueue queue;
     SolutionCollector collector;
     std::vector<std::thread> workers;
     std::atomic<int> tasks_completed{0};
     std::atomic<int> tasks_total{0};
+    std::atomic<int> tasks_failed{0};   // CRASHED or MEMOUT (process mode)
     std::mutex io_mutex;
+    
+    // Process-pool mode: 0 = run workers as threads
+    int num_procs = 0;
+    size_t mem_limit_mb = 0;
+    
+    // Coordinator mode: >0 = serve tasks to remote workers on this port
+    int coordinator_port = 0;
+    int lease_timeout_s = 0;
+    
+    // Task id range [task_begin, task_end) searched by this run (sharding)
+    int shard_index = 0;
+    int shard_count = 1;
+    int task_begin = 0;
+    int task_end = 0;
+    std::unique_ptr<ResultFile> result_file;
+    
+    // Within that range: one pair per relabelling orbit (see PairOrbits)
+    // and/or a seeded random sample of sample_size tasks
+    bool orbit_reduction = false;
+    int sample_size = 0;
+    uint64_t sample_seed = 1;
+    mutable long long orbit_pairs = 0;  // Pairs the selected representatives stand for
+    mutable int orbit_reps = 0;         // Representatives before sampling
+    
+    SolverConfig solver_config;
+    IncumbentBound incumbent;           // Shared bound when minimizing
+    CoreFacts core_facts;               // Shared UNSAT facts when core pruning
+    LemmaPool lemma_pool;               // Shared common-axiom lemmas (native engine)
+    std::atomic<int> tasks_pruned{0};
+    
+    // Pin each worker thread/process to its own CPU (NUMA-aware)
+    bool pin_workers = false;
+    std::vector<int> worker_cpus;
+    
+    // Generate-and-test mode: >0 = most common-axiom frames to store
+    size_t frame_budget = 0;
 
 public:
     ExhaustiveFrameFinder(int n, int threads = 0)
         : universe_size(n), 
-          num_threads(threads > 0 ? threads : std::thread::hardware_concurrency()) {
+          num_threads(threads > 0 ? threads : std::thread::hardware_concurrency()),
+          table(n), task_end(table.pair_count()), core_facts(table.count()) {
         if (num_threads == 0) num_threads = 4;  // Fallback
     }
     
+    // Restrict the search to shard k of N (0 <= k < N): a contiguous
+    // range of task ids, so N independent runs cover every pair once
+    void set_shard(int k, int N) {
+        int num_pairs = table.pair_count();
+        shard_index = k;
+        shard_count = N;
+        task_begin = static_cast<int>(static_cast<long long>(num_pairs) * k / N);
+        task_end = static_cast<int>(static_cast<long long>(num_pairs) * (k + 1) / N);
+    }
+    
+    // Restrict the search to the single task id k
+    void set_task(int k) {
+        task_begin = k;
+        task_end = k + 1;
+    }
+    
+    // Stream every task result to a ResultFile at path
+    bool write_results_to(const std::string& path) {
+        ResultFile::Header header{ResultFile::MAGIC, universe_size, shard_index, shard_count,
+                                  task_begin, task_end};
+        result_file.reset(new ResultFile());
+        if (!result_file->open_for_write(path, header)) {
+            std::cerr << "Cannot write result file " << path << ": " << std::strerror(errno) << "\n";
+            result_file.reset();
+            return false;
+        }
+        return true;
+    }
+    
+    // Options applied to every worker's TaskSolver; when minimizing,
+    // workers share this finder's incumbent bound
+    void set_solver_config(const SolverConfig& cfg) {
+        solver_config = cfg;
+        if (solver_config.minimize != MinimizeMode::NONE) solver_config.incumbent = &incumbent;
+        if (solver_config.core_pruning) solver_config.core_facts = &core_facts;
+        if (solver_config.share_lemmas) solver_config.lemmas = &lemma_pool;
+    }
+    
+    // Pin workers to CPUs spread over NUMA nodes (see CpuTopology)
+    void set_pinning(bool on) { pin_workers = on; }
+    
+    // Search one pair per orbit of Omega's permutations
+    void use_orbit_reduction(bool on) { orbit_reduction = on; }
+    
+    // Search k tasks drawn at random (seeded) from the selection
+    void set_sample(int k, uint64_t seed) {
+        sample_size = k;
+        sample_seed = seed;
+    }
+    
+    // Number of tasks this run covers
+    int task_count() const { return static_cast<int>(select_tasks().size()); }
+    
+    // Run workers as forked processes instead of threads (see ProcessPool)
+    void use_processes(int procs, size_t mem_mb) {
+        num_procs = procs;
+        mem_limit_mb = mem_mb;
+    }
+    
+    // Enumerate common-axiom frames once and test pairs natively
+    // (see CommonFrameSet); Z3 workers take over above the budget
+    void use_generate_and_test(size_t max_frames) { frame_budget = max_frames; }
+    
+    // Serve tasks to remote workers instead of solving locally (see TaskCoordinator)
+    void use_coordinator(int port, int lease_s) {
+        coordinator_port = port;
+        lease_timeout_s = lease_s;
+    }
+    
     // Main entry point: exhaustively search all partition pairs
     void find_all_frames() {
         auto start_time = std::chrono::steady_clock::now();
         
         // Generate all partition pairs
         std::cout << "Generating partition pairs for universe size " << universe_size << "...\n";
-        auto pairs = PartitionEnumerator::generate_partition_pairs(universe_size);
-        std::cout << "Generated " << pairs.size() << " partition pairs\n";
-        std::cout << "Using " << num_threads << " worker threads\n\n";
-        
-        tasks_total.store(static_cast<int>(pairs.size()));
+        int num_pairs = table.pair_count();
+        std::cout << "Generated " << num_pairs << " partition pairs\n";
+        if (shard_count > 1) {
+            std::cout << "Shard " << shard_index << "/" << shard_count << ": tasks ["
+                      << task_begin << ", " << task_end << ")\n";
+        }
         
-        // Populate task queue
-        for (size_t i = 0; i < pairs.size(); ++i) {
-            queue.push(Task{static_cast<int>(i), pairs[i].first, pairs[i].second});
+        std::vector<int> task_ids = select_tasks();
+        if (orbit_reduction) {
+            std::cout << "Orbit representatives: " << orbit_reps << " task(s) standing for "
+                      << orbit_pairs << " pair(s)\n";
         }
-        queue.mark_finished();
+        if (sample_size > 0) {
+            std::cout << "Sampled " << task_ids.size() << " task(s) (seed " << sample_seed << ")\n";
+        }
+        tasks_total.store(static_cast<int>(task_ids.size()));
         
-        // Launch workers
-        for (int i = 0; i < num_threads; ++i) {
-            workers.emplace_back([this, i]() {
-                ExhaustiveWorker worker(i, universe_size, queue, collector,
-                                        tasks_completed, tasks_total, io_mutex);
-                worker.run();
-            });
+        if (pin_workers && coordinator_port == 0) {
+            CpuTopology topo = CpuTopology::detect();
+            worker_cpus = topo.placement(num_procs > 0 ? num_procs : num_threads);
+            topo.print_placement(worker_cpus, num_procs > 0 ? "Process" : "Worker");
         }
         
-        // Wait for all workers
-        for (auto& t : workers) {
-            t.join();
+        if (coordinator_port > 0) {
+            run_coordinator(task_ids);
+        } else if (num_procs > 0) {
+            run_process_pool(task_ids);
+        } else if (frame_budget > 0) {
+            run_generate_and_test(task_ids);
+        } else {
+            run_thread_pool(task_ids);
         }
         
         auto end_time = std::chrono::steady_clock::now();
@@ -1700,8 +5987,121 @@ public:
         
         std::cout << "\n=== EXHAUSTIVE SEARCH COMPLETE ===\n";
         std::cout << "Total time: " << duration.count() << " ms\n";
-        std::cout << "Tasks completed: " << tasks_completed.load() << "/" << pairs.size() << "\n";
+        std::cout << "Tasks completed: " << tasks_completed.load() << "/" << task_ids.size() << "\n";
+        if (tasks_failed.load() > 0) {
+            std::cout << "Tasks failed (CRASHED/MEMOUT): " << tasks_failed.load() << "\n";
+        }
+        if (solver_config.minimize != MinimizeMode::NONE) {
+            std::cout << "Tasks pruned by incumbent: " << tasks_pruned.load() << "\n";
+            if (incumbent.get() != IncumbentBound::NONE) {
+                std::cout << "Best extension count: " << incumbent.get() << "\n";
+            }
+        }
+        if (solver_config.models) {
+            std::cout << "Frames enumerated: " << solver_config.models->models_written() << "\n";
+        }
+        if (solver_config.cross_check && num_procs == 0 && coordinator_port == 0) {
+            const auto& cc = TaskSolver::cross_check_stats();
+            std::cout << "Cross-checked tasks: " << cc.tasks.load() << " (mismatches: "
+                      << cc.mismatches.load() << "; Z3 " << cc.z3_us.load() / 1000
+                      << " ms, native " << cc.native_us.load() / 1000 << " ms)\n";
+        }
+        const auto& st = TaskSolver::sat_time_stats();
+        if (st.tasks.load() > 0 && num_procs == 0 && coordinator_port == 0) {
+            std::cout << "Time to SAT: " << st.us.load() / 1000 << " ms over " << st.tasks.load()
+                      << " SAT task(s), " << st.hinted.load() << " with phase hints\n";
+        }
+        if (TaskSolver::over_budget_count().load() > 0 && num_procs == 0 && coordinator_port == 0) {
+            std::cout << "Tasks over the memory budget (MEMOUT, not attempted): "
+                      << TaskSolver::over_budget_count().load() << "\n";
+        }
+        const auto& ls = TaskSolver::lazy_stats();
+        if (ls.rounds.load() > 0 && num_procs == 0 && coordinator_port == 0) {
+            std::cout << "Lazy axioms: " << ls.clauses.load() << " clause(s) over "
+                      << ls.rounds.load() << " check(s)\n";
+        }
+        const auto& rs = TaskSolver::recycle_stats();
+        if (rs.recycles.load() > 0 && num_procs == 0 && coordinator_port == 0) {
+            std::cout << "Context recycles: " << rs.recycles.load() << " (rebuild "
+                      << rs.rebuild_us.load() / rs.recycles.load() << " us each)\n";
+        }
+        if (solver_config.share_lemmas && num_procs == 0 && coordinator_port == 0) {
+            std::cout << "Shared lemmas: " << lemma_pool.size() << " (of at most "
+                      << LemmaPool::MAX_LITS << " literals; "
+                      << lemma_pool.unit_count() << " units)\n";
+        }
+        if (solver_config.core_pruning && num_procs == 0 && coordinator_port == 0) {
+            std::cout << "Tasks pruned by unsat cores: " << core_facts.pruned_count()
+                      << " (infeasible partitions: " << core_facts.infeasible_partition_count()
+                      << ", infeasible pairs: " << core_facts.infeasible_pair_count() << ")\n";
+        }
+        if (solver_config.model_reuse && num_procs == 0 && coordinator_port == 0 &&
+            frame_budget == 0) {
+            std::cout << "Tasks answered by model reuse: " << collector.reuse_count() << "\n";
+        }
+        std::cout << "Solutions found: " << collector.count() << "\n";
+    }
+    
+    // Merge shard result files into this finder's collector instead of
+    // searching. Duplicate task ids keep the most informative status
+    // (SAT/UNSAT over TIMEOUT over MEMOUT/CRASHED). Returns false if a
+    // file is unreadable or for a different universe size.
+    bool merge_result_files(const std::vector<std::string>& paths) {
+        std::map<int, TaskResult> merged;   // Ordered by task id
+        auto rank = [](TaskStatus st) {
+            switch (st) {
+                case TaskStatus::SAT:
+                case TaskStatus::UNSAT:   return 4;
+                case TaskStatus::PRUNED:  return 3;
+                case TaskStatus::TIMEOUT: return 2;
+                case TaskStatus::MEMOUT:  return 1;
+                case TaskStatus::CRASHED: return 0;
+            }
+            return 0;
+        };
+        
+        for (const auto& path : paths) {
+            ResultFile::Header header;
+            std::vector<TaskResult> results;
+            if (!ResultFile::read(path, header, results)) {
+                std::cerr << "Cannot read result file " << path << "\n";
+                return false;
+            }
+            if (header.universe_size != universe_size) {
+                std::cerr << path << ": universe size " << header.universe_size
+                          << " does not match " << universe_size << "\n";
+                return false;
+            }
+            std::cout << "Read " << path << ": shard " << header.shard_index << "/"
+                      << header.shard_count << ", " << results.size() << " record(s)\n";
+            for (auto& r : results) {
+                auto it = merged.find(r.task.id);
+                if (it == merged.end() || rank(r.status) > rank(it->second.status)) {
+                    merged[r.task.id] = std::move(r);
+                }
+            }
+        }
+        
+        int timeouts = 0;
+        for (const auto& [id, r] : merged) {
+            if (r.status == TaskStatus::SAT) {
+                collector.add_solution(id, r.task, r.matrix, universe_size);
+            } else if (r.status == TaskStatus::TIMEOUT) {
+                ++timeouts;
+            } else if (r.status != TaskStatus::UNSAT && r.status != TaskStatus::PRUNED) {
+                ++tasks_failed;
+            }
+        }
+        tasks_completed.store(static_cast<int>(merged.size()));
+        
+        std::cout << "\n=== MERGE COMPLETE ===\n";
+        std::cout << "Tasks covered: " << merged.size() << "/" << table.pair_count() << "\n";
+        if (timeouts > 0) std::cout << "Tasks timed out: " << timeouts << "\n";
+        if (tasks_failed.load() > 0) {
+            std::cout << "Tasks failed (CRASHED/MEMOUT): " << tasks_failed.load() << "\n";
+        }
         std::cout << "Solutions found: " << collector.count() << "\n";
+        return true;
     }
     
     // Get the solution collector
@@ -1730,9 +6130,12 @@ public:
         }
     }
     
-    // Display the minimal solution (smallest minimal_generator_count)
+    // Display the minimal solution (smallest minimal_generator_count, or
+    // fewest extensions when minimizing per task)
     void display_minimal_solution() {
-        const SolutionRecord* best = collector.find_minimal_solution();
+        bool by_extensions = solver_config.minimize != MinimizeMode::NONE;
+        const SolutionRecord* best = by_extensions ? collector.find_fewest_extensions_solution()
+                                                   : collector.find_minimal_solution();
         if (!best) {
             std::cout << "\nNo solutions found.\n";
             return;
@@ -1741,10 +6144,14 @@ public:
         int n = collector.get_universe_size();
         int ps = static_cast<int>(best->matrix.size());
         
-        std::cout << "\n=== MINIMAL SOLUTION (smallest generator count) ===\n";
+        if (by_extensions) {
+            std::cout << "\n=== MINIMAL SOLUTION (fewest extensions) ===\n";
+        } else {
+            std::cout << "\n=== MINIMAL SOLUTION (smallest generator count) ===\n";
+        }
         std::cout << "Task ID: " << best->task_id << "\n";
-        std::cout << "Partition I1: " << BitOps::partition_to_string(best->task.partition1, n) << "\n";
-        std::cout << "Partition I2: " << BitOps::partition_to_string(best->task.partition2, n) << "\n";
+        std::cout << "Partition I1: " << BitOps::partition_to_string(table.cells_of(best->task.partition1), n) << "\n";
+        std::cout << "Partition I2: " << BitOps::partition_to_string(table.cells_of(best->task.partition2), n) << "\n";
         std::cout << "Extension count: " << best->extension_count << "\n";
         std::cout << "Minimal generator count: " << best->minimal_generator_count << "\n";
         
@@ -1791,15 +6198,187 @@ public:
         }
         
         // Verify solution
-        verify_solution(best->matrix, best->task, n);
+        verify_solution(best->matrix, table.cells_of(best->task.partition1),
+                        table.cells_of(best->task.partition2), n);
         
         // Natural language description
         ModelAnalyzer::describe_model(best->matrix, n);
     }
 
 private:
+    // Task ids in [task_begin, task_end), reduced to orbit representatives
+    // and sampled as configured; ascending. Representatives are streamed
+    // from PairOrbits, so the full pair range is never listed when reducing.
+    std::vector<int> select_tasks() const {
+        std::vector<int> ids;
+        if (orbit_reduction && task_end - task_begin > 1) {
+            long long covered = 0;
+            PairOrbits(table).for_each_representative([&](int k, int orbit_size) {
+                if (k < task_begin || k >= task_end) return;
+                ids.push_back(k);
+                covered += orbit_size;
+            });
+            orbit_pairs = covered;
+            orbit_reps = static_cast<int>(ids.size());
+        } else {
+            for (int k = task_begin; k < task_end; ++k) ids.push_back(k);
+        }
+        if (sample_size > 0 && sample_size < static_cast<int>(ids.size())) {
+            std::mt19937_64 rng(sample_seed);
+            for (int k = 0; k < sample_size; ++k) {
+                std::uniform_int_distribution<size_t> pick(k, ids.size() - 1);
+                std::swap(ids[k], ids[pick(rng)]);
+            }
+            ids.resize(sample_size);
+            std::sort(ids.begin(), ids.end());
+        }
+        return ids;
+    }
+    
+    void run_thread_pool(const std::vector<int>& task_ids) {
+        std::cout << "Using " << num_threads << " worker threads\n\n";
+        
+        // Populate task queue
+        for (int k : task_ids) {
+            queue.push(Task::from_index(table, k));
+        }
+        queue.mark_finished();
+        
+        // Launch workers
+        for (int i = 0; i < num_threads; ++i) {
+            workers.emplace_back([this, i]() {
+                // Pin before the worker creates its context (first-touch placement)
+                if (!worker_cpus.empty()) {
+                    CpuTopology::pin_current_thread(worker_cpus[i % worker_cpus.size()]);
+                }
+                ExhaustiveWorker worker(i, table, queue, collector,
+                                        tasks_completed, tasks_total, io_mutex,
+                                        result_file.get(), solver_config, tasks_pruned);
+                worker.run();
+            });
+        }
+        
+        // Wait for all workers
+        for (auto& t : workers) {
+            t.join();
+        }
+    }
+    
+    void run_generate_and_test(const std::vector<int>& task_ids) {
+        using NativeFrame::Row;
+        auto start = std::chrono::steady_clock::now();
+        CommonFrameSet frames(universe_size);
+        if (universe_size > CommonFrameSet::MAX_UNIVERSE) {
+            std::cout << "Common-axiom frames are enumerated for n <= " << CommonFrameSet::MAX_UNIVERSE
+                      << " only; using Z3 workers\n";
+            run_thread_pool(task_ids);
+            return;
+        }
+        if (!frames.enumerate(frame_budget)) {
+            std::cout << "Common-axiom frames exceed the budget of " << frame_budget
+                      << "; using Z3 workers\n";
+            run_thread_pool(task_ids);
+            return;
+        }
+        int ps = frames.powerset_size();
+        size_t num_frames = frames.size();
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "Enumerated " << num_frames << " common-axiom frames in " << ms << " ms\n";
+        
+        // Not-Dilation per (frame, partition), shared by every pair
+        int num_partitions = table.count();
+        std::vector<uint8_t> not_dilation(num_frames * num_partitions);
+        auto parallel = [this](size_t count, const std::function<void(size_t)>& body) {
+            std::atomic<size_t> next{0};
+            std::vector<std::thread> threads;
+            for (int t = 0; t < num_threads; ++t) {
+                threads.emplace_back([&]() {
+                    for (size_t k; (k = next++) < count; ) body(k);
+                });
+            }
+            for (auto& t : threads) t.join();
+        };
+        FrameKernels kernels = FrameKernels::for_universe(universe_size);
+        parallel(num_frames, [&](size_t f) {
+            kernels.not_dilation_table(frames.frame(f), table, &not_dilation[f * num_partitions]);
+        });
+        
+        // Pairs in parallel: the first frame passing all pair axioms is the witness
+        parallel(task_ids.size(), [&](size_t k) {
+            Task task = Task::from_index(table, task_ids[k]);
+            CellSpan I1 = table.cells_of(task.partition1);
+            CellSpan I2 = table.cells_of(task.partition2);
+            std::vector<int> ck = NativeFrame::common_knowledge(I1, I2, universe_size);
+            TaskResult result;
+            result.task = task;
+            for (size_t f = 0; f < num_frames; ++f) {
+                if (!not_dilation[f * num_partitions + task.partition1] ||
+                    !not_dilation[f * num_partitions + task.partition2]) continue;
+                if (kernels.agreeing_to_disagree(frames.frame(f), I1, I2, ck)) {
+                    result.status = TaskStatus::SAT;
+                    result.matrix = NativeFrame::to_matrix(frames.frame(f), ps);
+                    break;
+                }
+            }
+            if (result_file) result_file->append(result);
+            if (result.status == TaskStatus::SAT) {
+                collector.add_solution(task.id, task, result.matrix, universe_size);
+            }
+            int completed = ++tasks_completed;
+            std::lock_guard<std::mutex> lock(io_mutex);
+            std::cout << "[Native] Task " << task.id << " done (" << status_name(result.status)
+                      << "). Progress: " << completed << "/" << tasks_total.load() << "\n";
+        });
+    }
+    
+    void run_process_pool(const std::vector<int>& task_ids) {
+        std::cout << "Using " << num_procs << " worker processes";
+        if (mem_limit_mb > 0) std::cout << " (memory limit " << mem_limit_mb << " MB each)";
+        std::cout << "\n\n";
+        
+        ProcessPool pool(table, num_procs, mem_limit_mb, solver_config);
+        pool.set_cpus(worker_cpus);
+        pool.run(task_ids, [this](int worker_id, const TaskResult& result) {
+            const Task& task = result.task;
+            if (result_file) result_file->append(result);
+            if (result.status == TaskStatus::PRUNED) ++tasks_pruned;
+            if (result.status == TaskStatus::SAT) {
+                collector.add_solution(task.id, task, result.matrix, universe_size);
+                std::cout << "[Process " << worker_id << "] Task " << task.id
+                          << " SAT - solution collected (total: " << collector.count() << ")\n";
+            } else if (result.status == TaskStatus::CRASHED || result.status == TaskStatus::MEMOUT) {
+                ++tasks_failed;
+            }
+            int completed = ++tasks_completed;
+            std::cout << "[Process " << worker_id << "] Task " << task.id
+                      << " done (" << status_name(result.status)
+                      << "). Progress: " << completed << "/" << tasks_total.load() << "\n";
+        });
+    }
+    
+    void run_coordinator(const std::vector<int>& task_ids) {
+        TaskCoordinator coordinator(table, coordinator_port, lease_timeout_s,
+                                    solver_config.totality != Totality::OFF);
+        bool ok = coordinator.run(task_ids, [this](const std::string& worker, const TaskResult& result) {
+            const Task& task = result.task;
+            if (result_file) result_file->append(result);
+            if (result.status == TaskStatus::PRUNED) ++tasks_pruned;
+            if (result.status == TaskStatus::SAT) {
+                collector.add_solution(task.id, task, result.matrix, universe_size);
+                std::cout << "[Worker " << worker << "] Task " << task.id
+                          << " SAT - solution collected (total: " << collector.count() << ")\n";
+            }
+            int completed = ++tasks_completed;
+            std::cout << "[Worker " << worker << "] Task " << task.id
+                      << " done (" << status_name(result.status)
+                      << "). Progress: " << completed << "/" << tasks_total.load() << "\n";
+        });
+        if (!ok) std::exit(1);
+    }
+    
     void verify_solution(const std::vector<std::vector<bool>>& matrix, 
-                         const Task& task, int n) {
+                         CellSpan I1, CellSpan I2, int n) {
         int ps = static_cast<int>(matrix.size());
         std::cout << "\n=== VERIFICATION ===\n";
         
@@ -1823,6 +6402,16 @@ private:
         }
         std::cout << "Transitivity: " << (transitive_ok ? "PASS" : "FAIL") << "\n";
         
+        if (solver_config.totality != Totality::OFF) {
+            bool total_ok = true;
+            for (int i = 0; i < ps && total_ok; ++i) {
+                for (int j = 0; j < ps && total_ok; ++j) {
+                    if (!matrix[i][j] && !matrix[j][i]) total_ok = false;
+                }
+            }
+            std::cout << "Totality: " << (total_ok ? "PASS" : "FAIL") << "\n";
+        }
+        
         // Check monotonicity
         bool monotonicity_ok = true;
         for (int i = 0; i < ps; ++i) {
@@ -1841,18 +6430,12 @@ private:
         
         // Check CSTP
         bool cstp_ok = true;
-        for (int A = 0; A < ps && cstp_ok; ++A) {
-            for (int B = 0; B < ps && cstp_ok; ++B) {
-                if (BitOps::set_intersection(A, B) != 0) continue;
-                for (int C = 0; C < ps && cstp_ok; ++C) {
-                    for (int D = 0; D < ps && cstp_ok; ++D) {
-                        if (BitOps::set_intersection(C, D) != 0) continue;
-                        int AB = BitOps::set_union(A, B);
-                        int CD = BitOps::set_union(C, D);
-                        if (matrix[A][C] && matrix[B][D] && !matrix[AB][CD]) {
-                            cstp_ok = false;
-                        }
-                    }
+        for (const auto& ab : SetTables::disjoint_pairs(ps)) {         // A and B disjoint
+            int A = ab.a, B = ab.b, AB = A | B;
+            for (const auto& cd : SetTables::disjoint_pairs(ps)) {     // C and D disjoint
+                int C = cd.a, D = cd.b, CD = C | D;
+                if (matrix[A][C] && matrix[B][D] && !matrix[AB][CD]) {
+                    cstp_ok = false;
                 }
             }
         }
@@ -1860,28 +6443,22 @@ private:
         
         // Check Strict CSTP
         bool strict_cstp_ok = true;
-        for (int A = 0; A < ps && strict_cstp_ok; ++A) {
-            for (int B = 0; B < ps && strict_cstp_ok; ++B) {
-                if (BitOps::set_intersection(A, B) != 0) continue;
-                for (int C = 0; C < ps && strict_cstp_ok; ++C) {
-                    for (int D = 0; D < ps && strict_cstp_ok; ++D) {
-                        if (BitOps::set_intersection(C, D) != 0) continue;
-                        int AB = BitOps::set_union(A, B);
-                        int CD = BitOps::set_union(C, D);
-                        bool A_less_C = matrix[A][C] && !matrix[C][A];
-                        bool B_less_D = matrix[B][D] && !matrix[D][B];
-                        bool AB_less_CD = matrix[AB][CD] && !matrix[CD][AB];
-                        if (A_less_C && B_less_D && !AB_less_CD) {
-                            strict_cstp_ok = false;
-                        }
-                    }
+        for (const auto& ab : SetTables::disjoint_pairs(ps)) {         // A and B disjoint
+            int A = ab.a, B = ab.b, AB = A | B;
+            for (const auto& cd : SetTables::disjoint_pairs(ps)) {     // C and D disjoint
+                int C = cd.a, D = cd.b, CD = C | D;
+                bool A_less_C = matrix[A][C] && !matrix[C][A];
+                bool B_less_D = matrix[B][D] && !matrix[D][B];
+                bool AB_less_CD = matrix[AB][CD] && !matrix[CD][AB];
+                if (A_less_C && B_less_D && !AB_less_CD) {
+                    strict_cstp_ok = false;
                 }
             }
         }
         std::cout << "Strict CSTP: " << (strict_cstp_ok ? "PASS" : "FAIL") << "\n";
         
         // Check Not Dilation for I1 and I2
-        auto check_not_dilation = [&](const std::vector<int>& partition, const std::string& name) {
+        auto check_not_dilation = [&](CellSpan partition, const std::string& name) {
             bool ok = true;
             for (int E = 0; E < ps && ok; ++E) {
                 for (int F = 0; F < ps && ok; ++F) {
@@ -1903,11 +6480,573 @@ private:
             std::cout << "Not Dilation (" << name << "): " << (ok ? "PASS" : "FAIL") << "\n";
         };
         
-        check_not_dilation(task.partition1, "I1");
-        check_not_dilation(task.partition2, "I2");
+        check_not_dilation(I1, "I1");
+        check_not_dilation(I2, "I2");
     }
 };
 
+// ============================================================
+//  RunOptions - Command line configuration
+// ============================================================
+//  example_groups [n] [threads] [--procs P] [--mem-limit-mb M]
+//                 [--coordinator PORT] [--lease-timeout-s S]
+//                 [--worker HOST:PORT]
+//                 [--shard K/N] [--out FILE] [--pin]
+//                 [--bench-pinning TASKS] [--auto-tune]
+//                 [--minimize] [--minimize-method totalizer|optimize]
+//                 [--task ID] [--enumerate FILE] [--model-limit N]
+//                 [--modulo-symmetry] [--count] [--count-common]
+//                 [--generate-and-test] [--frame-budget N]
+//                 [--engine z3|native] [--cross-check] [--no-model-reuse]
+//                 [--phase-hints] [--backbone] [--core-pruning]
+//                 [--share-lemmas] [--recycle-every K] [--recycle-above-mb M]
+//                 [--lazy-axioms] [--orbits] [--sample K] [--seed S]
+//                 [--mem-budget-gb G] [--a2d expanded|witness]
+//                 [--total] [--total-encoding ranks|clauses] [--verify-total]
+//                 [--relation matrix|rows]
+//  example_groups --merge FILE...
+//  Positional arguments keep their original meaning; flags select
+//  alternative execution modes.
+// ============================================================
+
+struct RunOptions {
+    int universe_size = 4;   // {0, 1, 2, 3}
+    int num_threads = 8;     // 8 threads as specified
+    int num_procs = 0;       // >0: forked worker processes instead of threads
+    size_t mem_limit_mb = 0; // Per-process memory cap (process mode only)
+    int coordinator_port = 0;        // >0: serve tasks to remote workers
+    int lease_timeout_s = TaskSolver::SOLVER_TIMEOUT_MS / 1000 + 600;
+    std::string worker_address;      // Non-empty: run as remote worker of HOST:PORT
+    int shard_index = 0;             // Shard K of N, 0 <= K < N
+    int shard_count = 1;
+    std::string result_path;         // Result file (default per shard when sharding)
+    std::vector<std::string> merge_files;  // Non-empty: merge these result files
+    bool pin = false;                // Pin workers to CPUs / NUMA nodes
+    int bench_pinning_tasks = 0;     // >0: benchmark pinned vs unpinned on this many tasks
+    bool auto_tune = false;          // Calibrate worker count and Z3 threads at startup
+    MinimizeMode minimize = MinimizeMode::NONE;  // Branch-and-bound on extension count
+    int task_id = -1;                // >=0: search this task only
+    std::string models_path;         // Non-empty: enumerate all frames per task into this file
+    uint64_t model_limit = 0;        // Frames per task when enumerating (0 = all)
+    bool modulo_symmetry = false;    // Enumerate one frame per automorphism orbit
+    bool count_frames = false;       // Count frames per task natively instead of solving
+    bool verify_total = false;       // Compare the two totality encodings' frame sets
+    bool count_common = false;       // Count frames of the common axioms alone
+    bool generate_and_test = false;  // Enumerate common-axiom frames, test pairs natively
+    size_t frame_budget = 4000000;   // Most common-axiom frames to store for that
+    SolverEngine engine = SolverEngine::Z3;  // Backend deciding each task
+    bool cross_check = false;        // Decide every task with both engines and compare
+    bool model_reuse = true;         // Test collected frames on each task before solving
+    bool phase_hints = false;        // Seed checks with a related earlier model
+    bool backbone = false;           // Fold the cached common-axiom backbone into encodings
+    bool core_pruning = false;       // Skip tasks proven UNSAT by other tasks' cores
+    bool share_lemmas = false;       // Native workers pool short common-axiom lemmas
+    int recycle_every = 0;           // Rebuild each worker's Z3 context every K tasks
+    size_t recycle_above_mb = 0;     // ... or above this Z3 allocation estimate
+    bool lazy_axioms = false;        // Transitivity/CSTP as cuts (always on for n = 7)
+    bool orbits = false;             // One partition pair per relabelling orbit
+    int sample_size = 0;             // >0: search this many randomly drawn tasks
+    uint64_t sample_seed = 1;
+    size_t mem_budget_mb = 0;        // Whole-run memory budget for worker threads
+    A2DEncoding a2d_encoding = A2DEncoding::EXPANDED;  // Witness is forced for n = 7
+    Totality totality = Totality::OFF;
+    RelationEncoding relation = RelationEncoding::MATRIX;
+};
+
+RunOptions parse_options(int argc, char* argv[]) {
+    RunOptions opts;
+    int positional = 0;
+    
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        auto next_value = [&]() -> const char* {
+            if (a + 1 >= argc) {
+                std::cerr << "Option " << arg << " needs a value.\n";
+                std::exit(2);
+            }
+            return argv[++a];
+        };
+        
+        if (arg == "--procs") {
+            opts.num_procs = std::atoi(next_value());
+            if (opts.num_procs < 1) {
+                opts.num_procs = std::thread::hardware_concurrency();
+                if (opts.num_procs == 0) opts.num_procs = 4;
+            }
+        } else if (arg == "--mem-limit-mb") {
+            long long mb = std::atoll(next_value());
+            opts.mem_limit_mb = mb > 0 ? static_cast<size_t>(mb) : 0;
+        } else if (arg == "--coordinator") {
+            opts.coordinator_port = std::atoi(next_value());
+            if (opts.coordinator_port <= 0 || opts.coordinator_port > 65535) {
+                std::cerr << "Invalid coordinator port.\n";
+                std::exit(2);
+            }
+        } else if (arg == "--lease-timeout-s") {
+            opts.lease_timeout_s = std::atoi(next_value());
+            if (opts.lease_timeout_s < 1) opts.lease_timeout_s = 1;
+        } else if (arg == "--worker") {
+            opts.worker_address = next_value();
+        } else if (arg == "--shard") {
+            std::string spec = next_value();
+            size_t slash = spec.find('/');
+            if (slash != std::string::npos) {
+                opts.shard_index = std::atoi(spec.substr(0, slash).c_str());
+                opts.shard_count = std::atoi(spec.substr(slash + 1).c_str());
+            }
+            if (slash == std::string::npos || opts.shard_count < 1 ||
+                opts.shard_index < 0 || opts.shard_index >= opts.shard_count) {
+                std::cerr << "--shard expects K/N with 0 <= K < N.\n";
+                std::exit(2);
+            }
+        } else if (arg == "--minimize") {
+            opts.minimize = MinimizeMode::TOTALIZER;
+        } else if (arg == "--minimize-method") {
+            std::string method = next_value();
+            if (method == "totalizer") {
+                opts.minimize = MinimizeMode::TOTALIZER;
+            } else if (method == "optimize") {
+                opts.minimize = MinimizeMode::OPTIMIZE;
+            } else {
+                std::cerr << "--minimize-method expects totalizer or optimize.\n";
+                std::exit(2);
+            }
+        } else if (arg == "--task") {
+            opts.task_id = std::atoi(next_value());
+        } else if (arg == "--enumerate") {
+            opts.models_path = next_value();
+        } else if (arg == "--model-limit") {
+            long long limit = std::atoll(next_value());
+            opts.model_limit = limit > 0 ? static_cast<uint64_t>(limit) : 0;
+        } else if (arg == "--modulo-symmetry") {
+            opts.modulo_symmetry = true;
+        } else if (arg == "--count") {
+            opts.count_frames = true;
+        } else if (arg == "--verify-total") {
+            opts.verify_total = true;
+        } else if (arg == "--engine") {
+            std::string engine = next_value();
+            if (engine == "z3") {
+                opts.engine = SolverEngine::Z3;
+            } else if (engine == "native") {
+                opts.engine = SolverEngine::NATIVE;
+            } else {
+                std::cerr << "--engine expects z3 or native.\n";
+                std::exit(2);
+            }
+        } else if (arg == "--cross-check") {
+            opts.cross_check = true;
+        } else if (arg == "--no-model-reuse") {
+            opts.model_reuse = false;
+        } else if (arg == "--phase-hints") {
+            opts.phase_hints = true;
+        } else if (arg == "--backbone") {
+            opts.backbone = true;
+        } else if (arg == "--core-pruning") {
+            opts.core_pruning = true;
+        } else if (arg == "--share-lemmas") {
+            opts.share_lemmas = true;
+        } else if (arg == "--recycle-every") {
+            opts.recycle_every = std::max(0, std::atoi(next_value()));
+        } else if (arg == "--recycle-above-mb") {
+            long long mb = std::atoll(next_value());
+            opts.recycle_above_mb = mb > 0 ? static_cast<size_t>(mb) : 0;
+        } else if (arg == "--lazy-axioms") {
+            opts.lazy_axioms = true;
+        } else if (arg == "--orbits") {
+            opts.orbits = true;
+        } else if (arg == "--sample") {
+            opts.sample_size = std::max(0, std::atoi(next_value()));
+        } else if (arg == "--seed") {
+            opts.sample_seed = std::strtoull(next_value(), nullptr, 10);
+        } else if (arg == "--mem-budget-gb") {
+            long long gb = std::atoll(next_value());
+            opts.mem_budget_mb = gb > 0 ? static_cast<size_t>(gb) * 1024 : 0;
+        } else if (arg == "--a2d") {
+            std::string encoding = next_value();
+            if (encoding == "expanded") {
+                opts.a2d_encoding = A2DEncoding::EXPANDED;
+            } else if (encoding == "witness") {
+                opts.a2d_encoding = A2DEncoding::WITNESS;
+            } else {
+                std::cerr << "--a2d expects expanded or witness.\n";
+                std::exit(2);
+            }
+        } else if (arg == "--total") {
+            if (opts.totality == Totality::OFF) opts.totality = Totality::RANKS;
+        } else if (arg == "--total-encoding") {
+            std::string encoding = next_value();
+            if (encoding == "ranks") {
+                opts.totality = Totality::RANKS;
+            } else if (encoding == "clauses") {
+                opts.totality = Totality::CLAUSES;
+            } else {
+                std::cerr << "--total-encoding expects ranks or clauses.\n";
+                std::exit(2);
+            }
+        } else if (arg == "--relation") {
+            std::string encoding = next_value();
+            if (encoding == "matrix") {
+                opts.relation = RelationEncoding::MATRIX;
+            } else if (encoding == "rows") {
+                opts.relation = RelationEncoding::ROWS;
+            } else {
+                std::cerr << "--relation expects matrix or rows.\n";
+                std::exit(2);
+            }
+        } else if (arg == "--count-common") {
+            opts.count_common = true;
+        } else if (arg == "--generate-and-test") {
+            opts.generate_and_test = true;
+        } else if (arg == "--frame-budget") {
+            long long budget = std::atoll(next_value());
+            opts.frame_budget = budget > 0 ? static_cast<size_t>(budget) : 1;
+        } else if (arg == "--auto-tune") {
+            opts.auto_tune = true;
+        } else if (arg == "--pin") {
+            opts.pin = true;
+        } else if (arg == "--bench-pinning") {
+            opts.bench_pinning_tasks = std::atoi(next_value());
+            if (opts.bench_pinning_tasks < 1) opts.bench_pinning_tasks = 1;
+        } else if (arg == "--out") {
+            opts.result_path = next_value();
+        } else if (arg == "--merge") {
+            while (a + 1 < argc && std::strncmp(argv[a + 1], "--", 2) != 0) {
+                opts.merge_files.push_back(argv[++a]);
+            }
+            if (opts.merge_files.empty()) {
+                std::cerr << "--merge needs at least one result file.\n";
+                std::exit(2);
+            }
+        } else if (arg.size() > 2 && arg[0] == '-' && arg[1] == '-') {
+            std::cerr << "Unknown option " << arg << ".\n";
+            std::exit(2);
+        } else if (positional == 0) {
+            ++positional;
+            opts.universe_size = std::atoi(arg.c_str());
+            if (opts.universe_size < 2 || opts.universe_size > SetTables::MAX_UNIVERSE) {
+                std::cerr << "Universe size must be between 2 and " << SetTables::MAX_UNIVERSE
+                          << ". Using default (4).\n";
+                opts.universe_size = 4;
+            }
+        } else if (positional == 1) {
+            ++positional;
+            opts.num_threads = std::atoi(arg.c_str());
+            if (opts.num_threads < 1) {
+                opts.num_threads = std::thread::hardware_concurrency();
+                if (opts.num_threads == 0) opts.num_threads = 16;
+            }
+        }
+    }
+    
+    if (opts.shard_count > 1 && opts.result_path.empty()) {
+        opts.result_path = "results_n" + std::to_string(opts.universe_size) + "_shard" +
+                           std::to_string(opts.shard_index) + "of" +
+                           std::to_string(opts.shard_count) + ".bin";
+    }
+    if (!opts.models_path.empty()) {
+        // Enumeration streams from worker threads into one local file
+        if (opts.num_procs > 0 || opts.coordinator_port > 0 || !opts.worker_address.empty() ||
+            opts.minimize != MinimizeMode::NONE) {
+            std::cerr << "--enumerate runs in thread mode only and not with --minimize.\n";
+            std::exit(2);
+        }
+    }
+    if (opts.minimize != MinimizeMode::NONE &&
+        (opts.coordinator_port > 0 || !opts.worker_address.empty())) {
+        // Remote workers neither receive the mode nor share the incumbent
+        std::cerr << "--minimize does not run with --coordinator or --worker.\n";
+        std::exit(2);
+    }
+    if (opts.cross_check &&
+        (opts.num_procs > 0 || opts.coordinator_port > 0 || !opts.worker_address.empty())) {
+        // Mismatches are counted per process and would not reach the exit status
+        std::cerr << "--cross-check runs in thread mode only.\n";
+        std::exit(2);
+    }
+    if ((opts.engine == SolverEngine::NATIVE || opts.cross_check) &&
+        (opts.minimize != MinimizeMode::NONE || !opts.models_path.empty())) {
+        std::cerr << "--minimize and --enumerate run on Z3 only.\n";
+        std::exit(2);
+    }
+    if (opts.models_path.empty() && (opts.model_limit > 0 || opts.modulo_symmetry)) {
+        std::cerr << "--model-limit and --modulo-symmetry apply to --enumerate only; ignoring.\n";
+    }
+    if (opts.core_pruning && (opts.engine == SolverEngine::NATIVE || opts.cross_check ||
+                              opts.minimize != MinimizeMode::NONE || !opts.models_path.empty())) {
+        std::cerr << "--core-pruning runs on the plain Z3 engine only.\n";
+        std::exit(2);
+    }
+    if (opts.core_pruning && (opts.num_procs > 0 || opts.coordinator_port > 0 ||
+                              !opts.worker_address.empty() || opts.generate_and_test)) {
+        std::cerr << "--core-pruning shares facts between threads only; ignoring.\n";
+        opts.core_pruning = false;
+    }
+    if (opts.share_lemmas && (opts.engine != SolverEngine::NATIVE || opts.num_procs > 0 ||
+                              opts.coordinator_port > 0 || !opts.worker_address.empty())) {
+        std::cerr << "--share-lemmas applies to --engine native worker threads only; ignoring.\n";
+        opts.share_lemmas = false;
+    }
+    if (opts.mem_limit_mb > 0 && opts.num_procs == 0) {
+        std::cerr << "--mem-limit-mb applies to --procs mode only; ignoring.\n";
+    }
+    if (opts.universe_size > NativeFrame::MAX_UNIVERSE &&
+        (opts.engine == SolverEngine::NATIVE || opts.cross_check || opts.count_frames ||
+         opts.count_common || opts.share_lemmas)) {
+        std::cerr << "The native engine and counting modes support n <= "
+                  << NativeFrame::MAX_UNIVERSE << "; n = " << opts.universe_size
+                  << " runs on Z3 only.\n";
+        std::exit(2);
+    }
+    if (opts.universe_size > NativeFrame::MAX_UNIVERSE &&
+        (opts.minimize != MinimizeMode::NONE || !opts.models_path.empty() || opts.core_pruning ||
+         opts.backbone)) {
+        // These modes encode transitivity and CSTP eagerly: millions of
+        // clauses per task at n = 7, where only lazy solving is practical
+        std::cerr << "--minimize, --enumerate, --core-pruning and --backbone need eager axioms; n = "
+                  << opts.universe_size << " runs with lazy axioms only.\n";
+        std::exit(2);
+    }
+    if (opts.verify_total && opts.universe_size > 4) {
+        std::cerr << "--verify-total enumerates every total frame; it supports n <= 4.\n";
+        std::exit(2);
+    }
+    if (opts.totality != Totality::OFF &&
+        (opts.engine == SolverEngine::NATIVE || opts.cross_check || opts.count_frames ||
+         opts.count_common || opts.generate_and_test || opts.share_lemmas)) {
+        std::cerr << "--total runs on the Z3 engine only.\n";
+        std::exit(2);
+    }
+    if (opts.relation == RelationEncoding::ROWS && (opts.backbone || opts.phase_hints)) {
+        // Both address R entries as Boolean constants
+        std::cerr << "--backbone and --phase-hints need --relation matrix; ignoring them.\n";
+        opts.backbone = false;
+        opts.phase_hints = false;
+    }
+    if (opts.lazy_axioms && (opts.minimize != MinimizeMode::NONE || !opts.models_path.empty() ||
+                             opts.core_pruning || opts.engine == SolverEngine::NATIVE)) {
+        std::cerr << "--lazy-axioms applies to plain Z3 solving only; ignoring.\n";
+        opts.lazy_axioms = false;
+    }
+    if (opts.mem_budget_mb > 0 && (opts.num_procs > 0 || opts.coordinator_port > 0)) {
+        std::cerr << "--mem-budget-gb applies to worker threads only; ignoring.\n";
+        opts.mem_budget_mb = 0;
+    }
+    return opts;
+}
+
+// Benchmark: solve the same evenly spaced sample of tasks with free-floating
+// and with pinned worker threads and compare throughput, e.g. on the n=5
+// task set: example_groups 5 16 --bench-pinning 64. Workers solve with
+// the run's solver configuration, as ExhaustiveWorker does.
+int run_pinning_benchmark(int universe_size, int num_threads, int num_tasks,
+                          const SolverConfig& config) {
+    PartitionTable table(universe_size);
+    int num_pairs = table.pair_count();
+    num_tasks = std::min(num_tasks, num_pairs);
+    std::vector<Task> sample;
+    for (int t = 0; t < num_tasks; ++t) {
+        sample.push_back(Task::from_index(table, static_cast<int>(
+            static_cast<long long>(t) * num_pairs / num_tasks)));
+    }
+    
+    CpuTopology topo = CpuTopology::detect();
+    std::vector<int> cpus = topo.placement(num_threads);
+    
+    std::cout << "===========================================\n";
+    std::cout << "   Pinning Benchmark (n=" << universe_size << ")\n";
+    std::cout << "===========================================\n\n";
+    std::cout << num_tasks << " of " << num_pairs << " tasks, " << num_threads << " threads\n";
+    topo.print_placement(cpus, "Worker");
+    std::cout << "\n";
+    
+    auto run = [&](bool pinned) {
+        std::atomic<size_t> next{0};
+        std::atomic<int> sat{0};
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_threads; ++i) {
+            threads.emplace_back([&, i]() {
+                if (pinned) CpuTopology::pin_current_thread(cpus[i % cpus.size()]);
+                TaskSolver solver(table, config);
+                for (size_t k; (k = next++) < sample.size(); ) {
+                    if (solver.solve(sample[k]).status == TaskStatus::SAT) ++sat;
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::setw(10) << (pinned ? "pinned" : "unpinned")
+                  << std::setw(12) << std::fixed << std::setprecision(2) << secs << " s"
+                  << std::setw(12) << std::setprecision(3) << sample.size() / secs << " tasks/s"
+                  << std::setw(8) << sat.load() << " SAT\n";
+        return secs;
+    };
+    
+    std::cout << std::setw(10) << "Mode" << std::setw(14) << "Wall" << std::setw(20) << "Throughput"
+              << std::setw(12) << "Found" << "\n";
+    double unpinned = run(false);
+    double pinned = run(true);
+    std::cout << "\nPinned speedup: " << std::setprecision(2) << unpinned / pinned << "x\n";
+    return 0;
+}
+
+// Count the frames of every task in [task_begin, task_end) with the
+// native counter, tasks spread over worker threads
+int run_frame_count(int universe_size, int num_threads, int task_begin, int task_end) {
+    PartitionTable table(universe_size);
+    
+    std::cout << "===========================================\n";
+    std::cout << "   Native Frame Count (n=" << universe_size << ")\n";
+    std::cout << "===========================================\n\n";
+    std::cout << "Tasks [" << task_begin << ", " << task_end << "), " << num_threads << " threads\n\n";
+    
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<int> next{task_begin};
+    std::atomic<int> incomplete{0};
+    std::mutex io_mutex;
+    std::map<int, uint64_t> counts;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&]() {
+            for (int k; (k = next++) < task_end; ) {
+                auto task_start = std::chrono::steady_clock::now();
+                FrameCounter counter(table, Task::from_index(table, k));
+                uint64_t frames = counter.count(TaskSolver::SOLVER_TIMEOUT_MS);
+                const auto& st = counter.stats();
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - task_start).count();
+                
+                std::lock_guard<std::mutex> lock(io_mutex);
+                std::cout << "Task " << k << ": ";
+                if (st.timed_out) {
+                    std::cout << "TIMEOUT";
+                    ++incomplete;
+                } else if (st.saturated) {
+                    std::cout << ">= 2^64 frames";
+                    ++incomplete;
+                } else {
+                    std::cout << frames << " frame(s)";
+                    counts[k] = frames;
+                }
+                std::cout << "  [" << st.nodes << " nodes, " << st.cache_hits << " cache hits, "
+                          << st.splits << " splits, " << ms << " ms]\n";
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    
+    uint64_t total = 0;
+    int sat = 0;
+    for (const auto& [k, frames] : counts) {
+        total += frames;
+        if (frames > 0) ++sat;
+    }
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "\n=== COUNT COMPLETE ===\n";
+    std::cout << "Total time: " << ms << " ms\n";
+    std::cout << "Tasks with frames: " << sat << "/" << counts.size() << "\n";
+    std::cout << "Total frames: " << total << "\n";
+    if (incomplete.load() > 0) std::cout << "Tasks not counted (timeout/overflow): " << incomplete.load() << "\n";
+    return incomplete.load() > 0 ? 1 : 0;
+}
+
+// Enumerate the frames of the common axioms plus totality under the rank
+// and the clause encoding (see encode_totality) and require the same
+// set from both, every frame passing the native axiom checks
+int run_total_verification(int universe_size) {
+    int ps = 1 << universe_size;
+    std::cout << "===========================================\n";
+    std::cout << "   Totality Encoding Check (n=" << universe_size << ")\n";
+    std::cout << "===========================================\n\n";
+    
+    auto enumerate = [&](Totality mode) {
+        z3::context ctx;
+        FrameVariables vars(ctx, universe_size, /*silent=*/true);
+        AxiomEncoder encoder(vars, /*silent=*/true);
+        encoder.set_totality(mode);
+        z3::solver solver(ctx, "QF_FD");
+        encoder.encode_common_axioms(solver);
+        std::set<std::vector<bool>> frames;
+        auto start = std::chrono::steady_clock::now();
+        while (solver.check() == z3::sat) {
+            z3::model m = solver.get_model();
+            std::vector<bool> frame(ps * ps);
+            z3::expr_vector block(ctx);
+            for (int i = 0; i < ps; ++i) {
+                for (int j = 0; j < ps; ++j) {
+                    frame[i * ps + j] = m.eval(vars.get_R(i, j), true).is_true();
+                    block.push_back(frame[i * ps + j] ? !vars.get_R(i, j) : vars.get_R(i, j));
+                }
+            }
+            frames.insert(std::move(frame));
+            solver.add(z3::mk_or(block));
+        }
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << (mode == Totality::RANKS ? "Ranks:   " : "Clauses: ") << frames.size()
+                  << " frame(s) [" << ms << " ms]\n";
+        return frames;
+    };
+    std::set<std::vector<bool>> ranks = enumerate(Totality::RANKS);
+    std::set<std::vector<bool>> clauses = enumerate(Totality::CLAUSES);
+    
+    int invalid = 0;
+    for (const auto& frame : ranks) {
+        std::vector<std::vector<bool>> matrix(ps, std::vector<bool>(ps));
+        bool total = true;
+        for (int i = 0; i < ps; ++i) {
+            for (int j = 0; j < ps; ++j) {
+                matrix[i][j] = frame[i * ps + j];
+                total &= frame[i * ps + j] || frame[j * ps + i];
+            }
+        }
+        std::vector<NativeFrame::Row> rows = NativeFrame::from_matrix(matrix);
+        if (!total || !NativeFrame::common_axioms(rows.data(), ps)) ++invalid;
+    }
+    bool same = ranks == clauses;
+    std::cout << "\nEncodings agree: " << (same ? "PASS" : "FAIL") << "\n";
+    std::cout << "Frames valid: " << (invalid == 0 ? "PASS" : "FAIL");
+    if (invalid > 0) std::cout << " (" << invalid << " invalid)";
+    std::cout << "\n";
+    return same && invalid == 0 ? 0 : 1;
+}
+
+// Merge shard result files and print the same report as a full run
+int merge_results(const std::vector<std::string>& files) {
+    ResultFile::Header header;
+    std::vector<TaskResult> ignored;
+    if (!ResultFile::read(files[0], header, ignored)) {
+        std::cerr << "Cannot read result file " << files[0] << "\n";
+        return 2;
+    }
+    if (header.universe_size < 2 || header.universe_size > SetTables::MAX_UNIVERSE) {
+        std::cerr << files[0] << ": unsupported universe size " << header.universe_size << "\n";
+        return 2;
+    }
+    
+    std::cout << "===========================================\n";
+    std::cout << "   Merging Shard Results\n";
+    std::cout << "===========================================\n\n";
+    
+    ExhaustiveFrameFinder finder(header.universe_size);
+    if (!finder.merge_result_files(files)) return 2;
+    
+    finder.display_summary();
+    finder.display_minimal_solution();
+    
+    const auto& collector = finder.get_collector();
+    int num_pairs = PartitionTable(header.universe_size).pair_count();
+    if (collector.count() > 0) {
+        std::cout << "\n=== SUCCESS ===\n";
+        std::cout << "Found " << collector.count() << " solutions out of " << num_pairs << " partition pairs.\n";
+        return 0;
+    }
+    std::cout << "\n=== NO SOLUTION FOUND ===\n";
+    return 1;
+}
+
 // ============================================================
 //  Main - EXHAUSTIVE Frame Finding for Universe Size 4
 // ============================================================
@@ -1916,23 +7055,122 @@ private:
 // ============================================================
 
 int main(int argc, char* argv[]) {
-    // Configuration - hardcoded for exhaustive search
-    int universe_size = 4;  // {0, 1, 2, 3}
-    int num_threads = 8;   // 8 threads as specified
+    // Configuration - defaults for exhaustive search, overridable from command line
+    RunOptions opts = parse_options(argc, argv);
+    int universe_size = opts.universe_size;
+    int num_threads = opts.num_threads;
+    
+    // Merge mode: combine shard result files, no search
+    if (!opts.merge_files.empty()) {
+        return merge_results(opts.merge_files);
+    }
+    
+    // Native counting mode: no Z3 search
+    if (opts.count_common) {
+        auto start = std::chrono::steady_clock::now();
+        FrameCounter counter(universe_size);
+        uint64_t frames = counter.count(TaskSolver::SOLVER_TIMEOUT_MS);
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        if (counter.stats().timed_out || counter.stats().saturated) {
+            std::cout << "Common-axiom frames (n=" << universe_size << "): not counted (timeout/overflow)\n";
+            return 1;
+        }
+        std::cout << "Common-axiom frames (n=" << universe_size << "): " << frames
+                  << "  [" << counter.stats().nodes << " nodes, " << ms << " ms]\n";
+        return 0;
+    }
+    if (opts.verify_total) {
+        return run_total_verification(universe_size);
+    }
+    if (opts.count_frames) {
+        int num_pairs = PartitionTable(universe_size).pair_count();
+        int begin = static_cast<int>(static_cast<long long>(num_pairs) * opts.shard_index / opts.shard_count);
+        int end = static_cast<int>(static_cast<long long>(num_pairs) * (opts.shard_index + 1) / opts.shard_count);
+        if (opts.task_id >= 0) {
+            if (opts.task_id >= num_pairs) {
+                std::cerr << "Task id must be below " << num_pairs << ".\n";
+                return 2;
+            }
+            begin = opts.task_id;
+            end = opts.task_id + 1;
+        }
+        return run_frame_count(universe_size, num_threads, begin, end);
+    }
+    
+    // Remote worker mode: universe size comes from the coordinator
+    if (!opts.worker_address.empty()) {
+        std::cout << "Connecting " << num_threads << " worker thread(s) to "
+                  << opts.worker_address << "\n";
+        SolverConfig worker_config;
+        worker_config.engine = opts.engine;
+        worker_config.recycle_every = opts.recycle_every;
+        worker_config.recycle_above_mb = opts.recycle_above_mb;
+        worker_config.lazy_axioms = opts.lazy_axioms;
+        worker_config.a2d_encoding = opts.a2d_encoding;
+        worker_config.totality = opts.totality;
+        worker_config.relation = opts.relation;
+        RemoteWorker worker(opts.worker_address, num_threads, worker_config);
+        int solved = worker.run();
+        if (solved < 0) return 1;
+        std::cout << "Coordinator finished; this worker solved " << solved << " task(s).\n";
+        return 0;
+    }
     
-    // Allow override from command line
-    if (argc >= 2) {
-        universe_size = std::atoi(argv[1]);
-        if (universe_size < 2 || universe_size > 6) {
-            std::cerr << "Universe size must be between 2 and 6. Using default (4).\n";
-            universe_size = 4;
+    // Calibrate pool size to this machine's CPUs and memory
+    SolverConfig solver_config;
+    solver_config.engine = opts.engine;
+    solver_config.cross_check = opts.cross_check;
+    solver_config.phase_hints = opts.phase_hints;
+    solver_config.core_pruning = opts.core_pruning;
+    solver_config.share_lemmas = opts.share_lemmas;
+    solver_config.recycle_every = opts.recycle_every;
+    solver_config.recycle_above_mb = opts.recycle_above_mb;
+    solver_config.lazy_axioms = opts.lazy_axioms;
+    solver_config.a2d_encoding = opts.a2d_encoding;
+    solver_config.totality = opts.totality;
+    solver_config.relation = opts.relation;
+    std::vector<int8_t> backbone;
+    if (opts.backbone) {
+        backbone = Backbone::load_or_compute(universe_size, Backbone::default_path(universe_size));
+        solver_config.backbone = &backbone;
+    }
+    // Reuse only where a task needs any witness: minimizing wants the
+    // best frame, enumeration all of them, cross-checking both engines
+    solver_config.model_reuse = opts.model_reuse && !opts.cross_check &&
+                                opts.minimize == MinimizeMode::NONE && opts.models_path.empty();
+    solver_config.minimize = opts.minimize;
+    if (opts.bench_pinning_tasks > 0) {
+        return run_pinning_benchmark(universe_size, num_threads, opts.bench_pinning_tasks, solver_config);
+    }
+    ModelStream model_stream;
+    if (!opts.models_path.empty()) {
+        if (!model_stream.open(opts.models_path, universe_size, opts.modulo_symmetry)) {
+            std::cerr << "Cannot write model file " << opts.models_path << "\n";
+            return 2;
+        }
+        solver_config.models = &model_stream;
+        solver_config.model_limit = opts.model_limit;
+        solver_config.modulo_symmetry = opts.modulo_symmetry;
+    }
+    if (opts.auto_tune && opts.coordinator_port == 0) {
+        int cpus = static_cast<int>(CpuTopology::detect().size());
+        AutoTuner::Result tuned = AutoTuner::calibrate(PartitionTable(universe_size), cpus, solver_config);
+        AutoTuner::print(tuned, cpus);
+        if (opts.num_procs > 0) {
+            opts.num_procs = tuned.workers;
+        } else {
+            num_threads = tuned.workers;
         }
+        solver_config.z3_threads = tuned.z3_threads;
     }
-    if (argc >= 3) {
-        num_threads = std::atoi(argv[2]);
-        if (num_threads < 1) {
-            num_threads = std::thread::hardware_concurrency();
-            if (num_threads == 0) num_threads = 16;
+    if (opts.mem_budget_mb > 0) {
+        // Each worker thread gets an equal share: tasks estimated above it
+        // are not attempted, and a context holding more than half of it
+        // between tasks is rebuilt
+        solver_config.task_budget_mb = opts.mem_budget_mb / num_threads;
+        if (solver_config.recycle_above_mb == 0) {
+            solver_config.recycle_above_mb = solver_config.task_budget_mb / 2;
         }
     }
     
@@ -1941,18 +7179,94 @@ int main(int argc, char* argv[]) {
     std::cout << "===========================================\n\n";
     std::cout << "Universe size: " << universe_size << " (Omega = {0.." << (universe_size-1) << "})\n";
     std::cout << "Powerset size: " << (1 << universe_size) << " subsets\n";
-    std::cout << "Threads: " << num_threads << "\n\n";
+    if (opts.coordinator_port > 0) {
+        std::cout << "Coordinator port: " << opts.coordinator_port << "\n\n";
+    } else if (opts.num_procs > 0) {
+        std::cout << "Processes: " << opts.num_procs << "\n\n";
+    } else {
+        std::cout << "Threads: " << num_threads << "\n\n";
+    }
+    if (solver_config.z3_threads > 1) {
+        std::cout << "Z3 internal threads per worker: " << solver_config.z3_threads << "\n\n";
+    }
+    if (solver_config.task_budget_mb > 0) {
+        std::cout << "Memory budget: " << opts.mem_budget_mb / 1024 << " GB, "
+                  << solver_config.task_budget_mb << " MB per worker\n\n";
+    }
+    if ((solver_config.lazy_axioms || universe_size > NativeFrame::MAX_UNIVERSE) &&
+        solver_config.minimize == MinimizeMode::NONE && !solver_config.models) {
+        std::cout << "Transitivity and CSTP: lazy (added as models violate them)\n\n";
+    }
+    if (solver_config.totality != Totality::OFF) {
+        std::cout << "Total preorders only ("
+                  << (solver_config.totality == Totality::RANKS ? "rank" : "clause")
+                  << " encoding; Not-Dilation holds trivially)\n\n";
+    }
+    if (solver_config.relation == RelationEncoding::ROWS && solver_config.engine == SolverEngine::Z3) {
+        std::cout << "Relation: " << (1 << universe_size) << " row bit-vectors (experimental)\n\n";
+    }
+    if (solver_config.a2d_encoding == A2DEncoding::WITNESS || universe_size > NativeFrame::MAX_UNIVERSE) {
+        std::cout << "A2D: symbolic E/F witnesses\n\n";
+    }
+    if (solver_config.engine == SolverEngine::NATIVE || solver_config.cross_check) {
+        std::cout << "Engine: " << (solver_config.engine == SolverEngine::NATIVE ? "native" : "Z3")
+                  << (solver_config.cross_check ? " (cross-checked against the other engine)" : "")
+                  << "\n\n";
+    }
+    if (solver_config.phase_hints) {
+        if (solver_config.engine == SolverEngine::Z3 && !HAVE_Z3_INITIAL_VALUE) {
+            std::cout << "Phase hints: need Z3 4.13.3 or later (built against "
+                      << Z3_MAJOR_VERSION << "." << Z3_MINOR_VERSION << "." << Z3_BUILD_NUMBER
+                      << "); only --engine native uses them\n\n";
+        } else {
+            std::cout << "Phase hints: previous model for the same I1, else the latest\n\n";
+        }
+    }
     
     // Calculate expected partition count (Bell number)
-    auto all_partitions = PartitionEnumerator::generate_all_partitions(universe_size);
-    int num_partitions = static_cast<int>(all_partitions.size());
-    int num_pairs = num_partitions * (num_partitions - 1);
+    PartitionTable partitions(universe_size);
+    int num_partitions = partitions.count();
+    int num_pairs = partitions.pair_count();
     
     std::cout << "Number of partitions (Bell(" << universe_size << ")): " << num_partitions << "\n";
     std::cout << "Number of partition pairs to search: " << num_pairs << "\n\n";
     
     // Run exhaustive parallel search
     ExhaustiveFrameFinder finder(universe_size, num_threads);
+    if (opts.coordinator_port > 0) {
+        finder.use_coordinator(opts.coordinator_port, opts.lease_timeout_s);
+    } else if (opts.num_procs > 0) {
+        finder.use_processes(opts.num_procs, opts.mem_limit_mb);
+    } else if (opts.generate_and_test) {
+        finder.use_generate_and_test(opts.frame_budget);
+    }
+    finder.set_pinning(opts.pin);
+    finder.set_solver_config(solver_config);
+    if (opts.task_id >= 0) {
+        if (opts.task_id >= num_pairs) {
+            std::cerr << "Task id must be below " << num_pairs << ".\n";
+            return 2;
+        }
+        finder.set_task(opts.task_id);
+        num_pairs = finder.task_count();
+    } else {
+        if (opts.shard_count > 1) finder.set_shard(opts.shard_index, opts.shard_count);
+        finder.use_orbit_reduction(opts.orbits);
+        if (opts.sample_size > 0) finder.set_sample(opts.sample_size, opts.sample_seed);
+        if (opts.shard_count > 1 || opts.orbits || opts.sample_size > 0) {
+            num_pairs = finder.task_count();
+        }
+    }
+    if (solver_config.models) {
+        std::cout << "Enumerating frames into " << opts.models_path;
+        if (opts.model_limit > 0) std::cout << " (at most " << opts.model_limit << " per task)";
+        if (opts.modulo_symmetry) std::cout << ", modulo pair automorphisms";
+        std::cout << "\n";
+    }
+    if (!opts.result_path.empty()) {
+        if (!finder.write_results_to(opts.result_path)) return 2;
+        std::cout << "Writing results to " << opts.result_path << "\n";
+    }
     
     finder.find_all_frames();
     
@@ -1962,6 +7276,14 @@ int main(int argc, char* argv[]) {
     // Display the minimal solution
     finder.display_minimal_solution();
     
+    // A disagreement between the engines fails the run, whatever was found
+    if (solver_config.cross_check && TaskSolver::cross_check_stats().mismatches.load() > 0) {
+        std::cout << "\n=== CROSS-CHECK FAILED ===\n";
+        std::cout << TaskSolver::cross_check_stats().mismatches.load()
+                  << " task(s) decided differently by the two engines.\n";
+        return 3;
+    }
+    
     const auto& collector = finder.get_collector();
     if (collector.count() > 0) {
         std::cout << "\n=== SUCCESS ===\n";